@@ -2,16 +2,27 @@
  * Bitstream-based Debounce Class Header File
  *
  * @file      BitDebounce.hpp
- * @brief     Uses 8-bit history to debounce the button state
+ * @brief     Uses a bit history to debounce the button state
  * @author    Simon Bluett
  * @website   https://wired.chillibasket.com/
  *
  * @copyright Copyright (C) 2021 - MIT License
- * @date      6th February 2021
- * @version   1.1
+ * @date      18th October 2026
+ * @version   1.2
  *
  * Based on the Ultimate Debouncer described by Elliot Williams:
  * https://hackaday.com/2015/12/10/embed-with-elliot-debounce-your-noisy-buttons-part-ii/
+ *
+ * The state changes when the newest "stable" readings have the new
+ * value and the oldest "prior" readings still have the old value (or
+ * when the whole history has the new value). The readings in between
+ * are ignored, since this is where the button bounces. For example,
+ * with an 8-bit history, 3 stable and 2 prior samples, the mask is
+ * 0b11000111 and a rising edge is detected by the pattern 0b00000111.
+ *
+ * Switches which bounce for longer (such as relays and reed switches)
+ * can use a longer history: BasicBitDebounce<uint16_t, 4, 4> button(pin);
+ * The default "BitDebounce" type uses the 8-bit history described above.
  * * * * * * * * * * * * * * * * * * * * * * */
 
 #ifndef BIT_DEBOUNCE_HPP
@@ -32,19 +43,26 @@ struct BitDebounceFlags {
 
 
 /**
- * @class BitDebounce
+ * @class BasicBitDebounce
+ *
+ * @tparam T      Type of the history (uint8_t, uint16_t or uint32_t)
+ * @tparam Stable Number of newest readings which need to have the new value
+ * @tparam Prior  Number of oldest readings which need to have the old value
  */
-class BitDebounce {
+template <typename T, uint8_t Stable, uint8_t Prior>
+class BasicBitDebounce {
 public:
 	// Constructor and destructor
-	BitDebounce(uint8_t pin);
-	~BitDebounce();
+	BasicBitDebounce(uint8_t pin);
+	~BasicBitDebounce();
 
 	// Initialise the button
 	void begin(bool enablePullup = true);
+	void setState(bool initialState);
 
 	// Update button reading
 	bool update();
+	bool update(bool readState);
 
 	// Functions to check for current state
 	bool read();
@@ -58,19 +76,35 @@ public:
 		uint16_t count();
 	#endif /* BIT_DEBOUNCE_COUNTER */
 
+	// Masks and patterns, calculated at compile time
+	static constexpr uint8_t bits() { return sizeof(T) * 8; }
+	static constexpr T allOnes() { return (T) ~((T) 0); }
+	static constexpr T stableMask() { return (T) (allOnes() >> (bits() - Stable)); }
+	static constexpr T priorMask() { return (Prior == 0)? 0 : (T) ((unsigned long) allOnes() << (bits() - Prior)); }
+	static constexpr T mask() { return stableMask() | priorMask(); }
+
+	static_assert(Stable > 0 && Stable + Prior <= sizeof(T) * 8, "History is too short for the number of samples");
+
 private:
 	struct BitDebounceFlags flags;
-	uint8_t buttonHistory;
+	T buttonHistory;
 	const uint8_t buttonPin;
 };
 
 
+/**
+ * Default debouncer, with an 8-bit history (mask 0b11000111)
+ */
+typedef BasicBitDebounce<uint8_t, 3, 2> BitDebounce;
+
+
 /**
  * Constructor
  *
  * @param  pin The I/O pin used for the button
  */
-BitDebounce::BitDebounce(uint8_t pin)
+template <typename T, uint8_t Stable, uint8_t Prior>
+BasicBitDebounce<T, Stable, Prior>::BasicBitDebounce(uint8_t pin)
 	: buttonPin(pin)
 {
 	// Empty, as all initialisation is done in the begin() function
@@ -80,7 +114,8 @@ BitDebounce::BitDebounce(uint8_t pin)
 /**
  * Default Destructor
  */
-BitDebounce::~BitDebounce() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+BasicBitDebounce<T, Stable, Prior>::~BasicBitDebounce() {
 	// Empty
 }
 
@@ -90,19 +125,31 @@ BitDebounce::~BitDebounce() {
  *
  * @param enablePullup  Whether to enable the internal pullup (default = true)
  */
-void BitDebounce::begin(bool enablePullup) {
+template <typename T, uint8_t Stable, uint8_t Prior>
+void BasicBitDebounce<T, Stable, Prior>::begin(bool enablePullup) {
 	
 	// Setup the pin
 	pinMode(buttonPin, (enablePullup)? INPUT_PULLUP : INPUT);
 
 	// Initialise other variables
-	const bool readState = digitalRead(buttonPin);
-	flags.currentState = readState;
+	setState(digitalRead(buttonPin));
+}
+
+
+/**
+ * Set the button state and fill the history, without using the pin
+ * (for example when the readings are passed to "update(readState)")
+ *
+ * @param initialState  The starting state of the button
+ */
+template <typename T, uint8_t Stable, uint8_t Prior>
+void BasicBitDebounce<T, Stable, Prior>::setState(bool initialState) {
+	flags.currentState = initialState;
 	flags.changeDetected = false;
 	#ifdef BIT_DEBOUNCE_COUNTER
 		flags.changeCounter = 0;
 	#endif /* BIT_DEBOUNCE_COUNTER */
-	if (readState) buttonHistory = 0b11111111;
+	if (initialState) buttonHistory = allOnes();
 	else buttonHistory = 0;
 }
 
@@ -112,16 +159,27 @@ void BitDebounce::begin(bool enablePullup) {
  *
  * @return Debounced button state
  */
-bool BitDebounce::update() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+bool BasicBitDebounce<T, Stable, Prior>::update() {
+	return update(digitalRead(buttonPin));
+}
 
-	const bool readState = digitalRead(buttonPin);
+
+/**
+ * Update the button state using a reading from another source
+ *
+ * @param  readState The latest reading of the button
+ * @return Debounced button state
+ */
+template <typename T, uint8_t Stable, uint8_t Prior>
+bool BasicBitDebounce<T, Stable, Prior>::update(bool readState) {
 
 	buttonHistory = (buttonHistory << 1);
 	buttonHistory |= readState;
 
 	if (flags.currentState != readState) {
 		if (flags.currentState) {
-			if ((buttonHistory & 0b11000111) == 0b11000000 || buttonHistory == 0b00000000) {
+			if ((buttonHistory & mask()) == priorMask() || buttonHistory == 0) {
 				flags.currentState = false;
 				flags.changeDetected = true;
 				#ifdef BIT_DEBOUNCE_COUNTER
@@ -129,7 +187,7 @@ bool BitDebounce::update() {
 				#endif /* BIT_DEBOUNCE_COUNTER */
 			}
 		} else {
-			if ((buttonHistory & 0b11000111) == 0b00000111 || buttonHistory == 0b11111111) {
+			if ((buttonHistory & mask()) == stableMask() || buttonHistory == allOnes()) {
 				flags.currentState = true;
 				flags.changeDetected = true;
 				#ifdef BIT_DEBOUNCE_COUNTER
@@ -148,7 +206,8 @@ bool BitDebounce::update() {
  *
  * @return Debounced button State
  */
-bool BitDebounce::read() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+bool BasicBitDebounce<T, Stable, Prior>::read() {
 	return flags.currentState;
 }
 
@@ -158,7 +217,8 @@ bool BitDebounce::read() {
  *
  * @return True on rising/falling edge, false otherwise
  */
-bool BitDebounce::onChange() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+bool BasicBitDebounce<T, Stable, Prior>::onChange() {
 	if (flags.changeDetected) {
 		flags.changeDetected = false;
 		return true;
@@ -172,7 +232,8 @@ bool BitDebounce::onChange() {
  *
  * @return True if rising edge detected
  */
-bool BitDebounce::onRisingEdge() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+bool BasicBitDebounce<T, Stable, Prior>::onRisingEdge() {
 	if (flags.currentState && flags.changeDetected) {
 		flags.changeDetected = false;
 		return true;
@@ -186,7 +247,8 @@ bool BitDebounce::onRisingEdge() {
  *
  * @return True if falling edge detected
  */
-bool BitDebounce::onFallingEdge() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+bool BasicBitDebounce<T, Stable, Prior>::onFallingEdge() {
 	if (!flags.currentState && flags.changeDetected) {
 		flags.changeDetected = false;
 		return true;
@@ -201,7 +263,8 @@ bool BitDebounce::onFallingEdge() {
  *
  * @return The number of full button press & releases
  */
-uint16_t BitDebounce::count() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+uint16_t BasicBitDebounce<T, Stable, Prior>::count() {
 	// Counter records presses and releases, so divide by 2
 	return flags.changeCounter / 2;
 }
@@ -210,7 +273,8 @@ uint16_t BitDebounce::count() {
 /**
  * Reset the button click counter
  */
-void BitDebounce::reset() {
+template <typename T, uint8_t Stable, uint8_t Prior>
+void BasicBitDebounce<T, Stable, Prior>::reset() {
 	// Set counter to 1 if button is currently pressed, 0 otherwise
 	flags.changeCounter = !flags.currentState;
 }
@@ -0,0 +1,374 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Button Event Queue Class Header File
+ *
+ * @file      ButtonEvents.hpp
+ * @brief     Turn debounced button states into timestamped events
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * The edge flags of the debounce classes are cleared when they are
+ * read, so if the main loop is slow some edges can be missed. This
+ * file adds a layer on top of the debounce classes, which recognises
+ * gestures (press, release, long press, repeat and multi-clicks) and
+ * saves them into a small ring buffer together with the time at which
+ * they happened. The main loop can then handle the events of all
+ * buttons from one queue, whenever it has time.
+ *
+ * The "update()" functions of the buttons can also be called from a
+ * timer interrupt. The queue only has one writer and one reader, so
+ * no interrupts need to be disabled (apart from briefly in "clear()"),
+ * as long as all of the buttons sharing a queue are updated from the
+ * same place.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef BUTTON_EVENTS_HPP
+#define BUTTON_EVENTS_HPP
+
+// Required for millis()
+#include <Arduino.h>
+
+/**
+ * Size of the event queue (must be a power of 2). One slot is always
+ * kept empty, so the queue can hold up to "size - 1" events
+ */
+#ifndef BUTTON_EVENTS_QUEUE_SIZE
+#define BUTTON_EVENTS_QUEUE_SIZE 8
+#endif
+
+/**
+ * Compiler barrier, which stops the compiler from moving the accesses to
+ * the events array past the update of the head or tail index
+ */
+#define BUTTON_EVENTS_BARRIER() asm volatile("" ::: "memory")
+
+// Default gesture timings in milliseconds
+#define BUTTON_EVENTS_LONG_PRESS 800   // Time held before a long press
+#define BUTTON_EVENTS_REPEAT     200   // Time between repeats while held (0 = off)
+#define BUTTON_EVENTS_CLICK_GAP  300   // Maximum time between clicks of a multi-click
+
+
+/**
+ * Event types
+ */
+enum button_event_t {
+	event_none = 0,        // No event (queue was empty)
+	event_press = 1,       // Button was pressed
+	event_release = 2,     // Button was released
+	event_long_press = 3,  // Button was held for the long press time
+	event_repeat = 4,      // Button is still held after a long press
+	event_click = 5        // One or more short clicks finished (see "clicks")
+};
+
+
+/**
+ * A timestamped button event
+ */
+struct ButtonEvent {
+	uint8_t type;        // See "button_event_t"
+	uint8_t button;      // ID of the button
+	uint8_t clicks;      // Number of clicks (event_click only)
+	unsigned long time;  // Time of the event (milliseconds)
+};
+
+
+/**
+ * @class ButtonEventQueue
+ *
+ * Ring buffer of button events, which can be shared by many buttons
+ */
+class ButtonEventQueue {
+public:
+	ButtonEventQueue();
+
+	bool push(const struct ButtonEvent &event);
+	bool pop(struct ButtonEvent &event);
+	bool available();
+	uint8_t overflows();
+	void clear();
+
+private:
+	struct ButtonEvent events[BUTTON_EVENTS_QUEUE_SIZE];
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	volatile uint8_t overflowCounter;
+};
+
+
+/**
+ * Gesture states
+ */
+enum button_gesture_t {
+	gesture_idle = 0,      // Released, no clicks are being counted
+	gesture_pressed = 1,   // Pressed, waiting for the long press time
+	gesture_held = 2,      // Held after a long press
+	gesture_clicked = 3    // Released, waiting to see if another click follows
+};
+
+
+/**
+ * @class ButtonEvents
+ *
+ * Gesture state machine for one button
+ */
+class ButtonEvents {
+public:
+	ButtonEvents(ButtonEventQueue &eventQueue, uint8_t id, bool activeLow = true);
+
+	void setTimings(uint16_t longPress, uint16_t repeat, uint16_t clickGap);
+
+	void update(bool state);
+	void update(bool state, unsigned long time);
+
+	bool pressed();
+
+private:
+	void addEvent(uint8_t type, unsigned long time);
+
+	ButtonEventQueue &queue;
+	unsigned long gestureTimer;
+	uint16_t longPressTime;
+	uint16_t repeatTime;
+	uint16_t clickGapTime;
+	const uint8_t buttonId;
+	const bool inverted;
+	bool lastPressed;
+	uint8_t gesture;
+	uint8_t clickCounter;
+};
+
+
+/**
+ * Constructor
+ */
+ButtonEventQueue::ButtonEventQueue()
+	: head(0)
+	, tail(0)
+	, overflowCounter(0)
+{
+	// Empty
+}
+
+
+/**
+ * Add an event to the back of the queue
+ *
+ * @param  event The event to be added
+ * @return True if successful, false if the queue was full
+ */
+bool ButtonEventQueue::push(const struct ButtonEvent &event) {
+	const uint8_t next = (head + 1) & (BUTTON_EVENTS_QUEUE_SIZE - 1);
+
+	if (next == tail) {
+		if (overflowCounter < 255) overflowCounter++;
+		return false;
+	}
+
+	// The event has to be written before the reader can see the new head
+	events[head] = event;
+	BUTTON_EVENTS_BARRIER();
+	head = next;
+	return true;
+}
+
+
+/**
+ * Get the oldest event from the queue
+ *
+ * @param[out] event The event which was removed from the queue
+ * @return     True if an event was available, false if the queue was empty
+ */
+bool ButtonEventQueue::pop(struct ButtonEvent &event) {
+	if (tail == head) {
+		event.type = event_none;
+		return false;
+	}
+
+	// The event has to be read before the writer can reuse its slot
+	event = events[tail];
+	BUTTON_EVENTS_BARRIER();
+	tail = (tail + 1) & (BUTTON_EVENTS_QUEUE_SIZE - 1);
+	return true;
+}
+
+
+/**
+ * Check if there are any events in the queue
+ *
+ * @return True if there are events, false otherwise
+ */
+bool ButtonEventQueue::available() {
+	return tail != head;
+}
+
+
+/**
+ * Get the number of events which were lost because the queue was full
+ *
+ * @return The number of lost events (up to 255)
+ */
+uint8_t ButtonEventQueue::overflows() {
+	return overflowCounter;
+}
+
+
+/**
+ * Remove all events from the queue and reset the overflow counter
+ */
+void ButtonEventQueue::clear() {
+	// On AVR the interrupt state is restored afterwards, so this can
+	// also be called while the interrupts are already disabled
+	#ifdef SREG
+		uint8_t oldSREG = SREG;
+		cli();
+	#else
+		noInterrupts();
+	#endif
+
+	tail = head;
+	overflowCounter = 0;
+
+	#ifdef SREG
+		SREG = oldSREG;
+	#else
+		interrupts();
+	#endif
+}
+
+
+/**
+ * Constructor
+ *
+ * @param  eventQueue The queue into which the events are saved
+ * @param  id         ID of the button, which is saved in each event
+ * @param  activeLow  True if the button reads LOW when pressed (default = true, for pullups)
+ */
+ButtonEvents::ButtonEvents(ButtonEventQueue &eventQueue, uint8_t id, bool activeLow)
+	: queue(eventQueue)
+	, gestureTimer(0)
+	, longPressTime(BUTTON_EVENTS_LONG_PRESS)
+	, repeatTime(BUTTON_EVENTS_REPEAT)
+	, clickGapTime(BUTTON_EVENTS_CLICK_GAP)
+	, buttonId(id)
+	, inverted(activeLow)
+	, lastPressed(false)
+	, gesture(gesture_idle)
+	, clickCounter(0)
+{
+	// Empty
+}
+
+
+/**
+ * Change the timings of the gestures
+ *
+ * @param  longPress Time in milliseconds before a press becomes a long press
+ * @param  repeat    Time in milliseconds between repeat events while held (0 = off)
+ * @param  clickGap  Maximum time in milliseconds between the clicks of a multi-click
+ */
+void ButtonEvents::setTimings(uint16_t longPress, uint16_t repeat, uint16_t clickGap) {
+	longPressTime = longPress;
+	repeatTime = repeat;
+	clickGapTime = clickGap;
+}
+
+
+/**
+ * Update the gesture state machine
+ *
+ * This should be called regularly with the debounced button state,
+ * for example "update(button.update())", even if the state did not
+ * change, so that the long press and click timers can be checked.
+ *
+ * @param  state The debounced button state (HIGH/LOW)
+ * @param  time  The current time in milliseconds (default = millis())
+ */
+void ButtonEvents::update(bool state) {
+	update(state, millis());
+}
+
+void ButtonEvents::update(bool state, unsigned long time) {
+	const bool isPressed = state ^ inverted;
+
+	// Button was pressed
+	if (isPressed && !lastPressed) {
+
+		// Finish any clicks which were not reported in time
+		if (gesture == gesture_clicked && time - gestureTimer > clickGapTime) {
+			addEvent(event_click, time);
+			clickCounter = 0;
+		}
+
+		addEvent(event_press, time);
+		gesture = gesture_pressed;
+		gestureTimer = time;
+
+	// Button was released
+	} else if (!isPressed && lastPressed) {
+		addEvent(event_release, time);
+
+		// A long press is not counted as a click
+		if (gesture == gesture_held) {
+			gesture = gesture_idle;
+			clickCounter = 0;
+		} else {
+			if (clickCounter < 255) clickCounter++;
+			gesture = gesture_clicked;
+			gestureTimer = time;
+		}
+
+	// Button is being held
+	} else if (isPressed) {
+		if (gesture == gesture_pressed && time - gestureTimer >= longPressTime) {
+
+			// Report clicks before the long press (for example "click + hold")
+			if (clickCounter > 0) addEvent(event_click, time);
+			addEvent(event_long_press, time);
+			gesture = gesture_held;
+			gestureTimer = time;
+			clickCounter = 0;
+		} else if (gesture == gesture_held && repeatTime > 0 && time - gestureTimer >= repeatTime) {
+			addEvent(event_repeat, time);
+			gestureTimer += repeatTime;
+		}
+
+	// No more clicks followed, so report the number of clicks
+	} else if (gesture == gesture_clicked && time - gestureTimer > clickGapTime) {
+		addEvent(event_click, time);
+		gesture = gesture_idle;
+		clickCounter = 0;
+	}
+
+	lastPressed = isPressed;
+}
+
+
+/**
+ * Check if the button is currently pressed
+ *
+ * @return True if pressed, false otherwise
+ */
+bool ButtonEvents::pressed() {
+	return lastPressed;
+}
+
+
+/**
+ * Save an event into the queue
+ *
+ * @param  type The type of event
+ * @param  time The time of the event
+ */
+void ButtonEvents::addEvent(uint8_t type, unsigned long time) {
+	struct ButtonEvent event;
+	event.type = type;
+	event.button = buttonId;
+	event.clicks = (type == event_click)? clickCounter : 0;
+	event.time = time;
+	queue.push(event);
+}
+
+#endif /* BUTTON_EVENTS_HPP */
@@ -0,0 +1,214 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Shared Debounce Scheduler Class Header File
+ *
+ * @file      DebounceScheduler.hpp
+ * @brief     Debounce many buttons from one timer interrupt
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * Every TimeDebounce object has its own 32-bit timer and calls
+ * millis() on every update. When there are many buttons, this class
+ * uses much less memory: all buttons are updated together by calling
+ * "tick()" at a fixed rate (for example from a timer interrupt set
+ * up using "setupTimers.h"), so each button only needs its pin number
+ * and an 8-bit counter of how many ticks the reading has differed
+ * from the debounced state. The states of all buttons are stored as
+ * bitmasks, so each button uses about 2.25 bytes of memory in total
+ * (pin, counter and two state bits).
+ *
+ * The main loop can read a consistent copy of all states at any time
+ * using "snapshot()", without disabling the interrupts. This uses a
+ * sequence counter, which is odd while the interrupt is writing.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef DEBOUNCE_SCHEDULER_HPP
+#define DEBOUNCE_SCHEDULER_HPP
+
+// Required for digitalRead()
+#include <Arduino.h>
+
+
+/**
+ * @class DebounceScheduler
+ *
+ * @tparam N The number of buttons (up to 32)
+ */
+template <uint8_t N>
+class DebounceScheduler {
+public:
+	// Constructor
+	DebounceScheduler(uint8_t ticks = 10);
+
+	// Initialise the buttons
+	void begin(const uint8_t (&pins)[N], bool enablePullup = true);
+
+	// Update all buttons, called at a fixed rate
+	void tick();
+
+	// Functions to check the current state
+	uint32_t snapshot();
+	bool read(uint8_t button);
+	uint32_t onChange();
+
+	static_assert(N > 0 && N <= 32, "DebounceScheduler supports 1 to 32 buttons");
+
+private:
+	uint8_t buttonPins[N];
+	uint8_t counters[N];
+	const uint8_t debounceTicks;
+
+	// Shared with the interrupt
+	volatile uint32_t currentStates;
+	volatile uint32_t changeDetected;
+	volatile uint8_t sequence;
+};
+
+
+/**
+ * Constructor
+ *
+ * @param  ticks Number of ticks which the reading needs to stay the same before
+ *               the state changes (default = 10, or 10ms when ticking at 1kHz)
+ */
+template <uint8_t N>
+DebounceScheduler<N>::DebounceScheduler(uint8_t ticks)
+	: debounceTicks(ticks)
+	, currentStates(0)
+	, changeDetected(0)
+	, sequence(0)
+{
+	// Empty, as the pins are set up in the begin() function
+}
+
+
+/**
+ * Initialise the button pins
+ *
+ * This should be called before the timer which calls "tick()" is started.
+ *
+ * @param  pins          Array containing the pin of each button
+ * @param  enablePullup  Whether to enable the internal pullups (default = true)
+ */
+template <uint8_t N>
+void DebounceScheduler<N>::begin(const uint8_t (&pins)[N], bool enablePullup) {
+	uint32_t states = 0;
+
+	for (uint8_t i = 0; i < N; i++) {
+		buttonPins[i] = pins[i];
+		counters[i] = 0;
+		pinMode(pins[i], (enablePullup)? INPUT_PULLUP : INPUT);
+		if (digitalRead(pins[i])) states |= (uint32_t) 1 << i;
+	}
+
+	currentStates = states;
+	changeDetected = 0;
+}
+
+
+/**
+ * Update the state of all buttons
+ *
+ * This should be called at a fixed rate, usually from a timer interrupt.
+ * The state of a button changes once its reading has been different
+ * for the number of ticks set in the constructor.
+ */
+template <uint8_t N>
+void DebounceScheduler<N>::tick() {
+	uint32_t states = currentStates;
+	uint32_t toggle = 0;
+	uint32_t bit = 1;
+
+	for (uint8_t i = 0; i < N; i++, bit <<= 1) {
+		const bool readState = digitalRead(buttonPins[i]);
+
+		if (readState != ((states & bit) != 0)) {
+			if (++counters[i] >= debounceTicks) {
+				toggle |= bit;
+				counters[i] = 0;
+			}
+
+		// Reading went back to the current state, so restart the count
+		} else {
+			counters[i] = 0;
+		}
+	}
+
+	// Publish the new states; the sequence is odd while writing
+	if (toggle) {
+		sequence++;
+		currentStates = states ^ toggle;
+		changeDetected |= toggle;
+		sequence++;
+	}
+}
+
+
+/**
+ * Get the debounced state of all buttons
+ *
+ * If the interrupt updates the states while they are being copied,
+ * the copy is repeated, so the result is always consistent.
+ *
+ * @return One bit per button, in the order of the pins given to begin()
+ */
+template <uint8_t N>
+uint32_t DebounceScheduler<N>::snapshot() {
+	uint8_t start;
+	uint32_t states;
+
+	do {
+		start = sequence;
+		states = currentStates;
+	} while ((start & 1) || start != sequence);
+
+	return states;
+}
+
+
+/**
+ * Read the debounced state of one button
+ *
+ * @param  button The number of the button (position in the pin array)
+ * @return Debounced button state
+ */
+template <uint8_t N>
+bool DebounceScheduler<N>::read(uint8_t button) {
+	return (snapshot() >> button) & 1;
+}
+
+
+/**
+ * Check which buttons have changed state since the last call
+ *
+ * @return Bits set for every button with a rising/falling edge
+ */
+template <uint8_t N>
+uint32_t DebounceScheduler<N>::onChange() {
+
+	// The value needs to be read and cleared without being interrupted.
+	// On AVR the interrupt state is restored afterwards, so this can
+	// also be called while the interrupts are already disabled
+	#ifdef SREG
+		uint8_t oldSREG = SREG;
+		cli();
+	#else
+		noInterrupts();
+	#endif
+
+	const uint32_t changes = changeDetected;
+	changeDetected = 0;
+
+	#ifdef SREG
+		SREG = oldSREG;
+	#else
+		interrupts();
+	#endif
+
+	return changes;
+}
+
+#endif /* DEBOUNCE_SCHEDULER_HPP */
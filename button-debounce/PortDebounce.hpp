@@ -0,0 +1,178 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Port-wide Parallel Debounce Class Header File
+ *
+ * @file      PortDebounce.hpp
+ * @brief     Debounce up to 32 buttons at the same time
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * Instead of reading and debouncing each button separately, this
+ * class takes a whole word of readings at once (for example the
+ * PIND register, or several ports combined into one number) and
+ * debounces every bit in parallel using "vertical counters".
+ *
+ * Each bit has a 2-bit counter, where the lower bits of all the
+ * counters are stored in one word and the upper bits in another.
+ * A counter increases while the reading differs from the debounced
+ * state, and is reset when the reading is the same. When it rolls
+ * over (after 4 consecutive different readings) the state changes.
+ * This only takes a few logic operations per update, no matter how
+ * many buttons there are.
+ *
+ * Based on the vertical counter debouncer by Scott Dattalo:
+ * http://www.dattalo.com/technical/software/pic/debounce.html
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PORT_DEBOUNCE_HPP
+#define PORT_DEBOUNCE_HPP
+
+
+/**
+ * @class PortDebounce
+ *
+ * @tparam T The unsigned integer type holding one bit per button
+ *           (uint8_t, uint16_t or uint32_t)
+ */
+template <typename T>
+class PortDebounce {
+public:
+	// Constructor
+	PortDebounce(T initialState = 0);
+
+	// Initialise the debounced state
+	void begin(T initialState);
+
+	// Update all buttons with a new reading
+	T update(T reading);
+
+	// Functions to check the current state (one bit per button)
+	T read();
+	bool read(uint8_t bit);
+	T onChange();
+	T onRisingEdge();
+	T onFallingEdge();
+
+private:
+	T currentState;
+	T changeDetected;
+	T counterLow;
+	T counterHigh;
+};
+
+
+/**
+ * Constructor
+ *
+ * @param  initialState The starting state of the buttons (default = 0)
+ */
+template <typename T>
+PortDebounce<T>::PortDebounce(T initialState) {
+	begin(initialState);
+}
+
+
+/**
+ * Set the debounced state and clear all counters and edge flags
+ *
+ * @param  initialState The current state of the buttons
+ */
+template <typename T>
+void PortDebounce<T>::begin(T initialState) {
+	currentState = initialState;
+	changeDetected = 0;
+	counterLow = 0;
+	counterHigh = 0;
+}
+
+
+/**
+ * Update the state of all buttons
+ *
+ * @param  reading The latest reading, with one bit per button
+ * @return Debounced button states
+ */
+template <typename T>
+T PortDebounce<T>::update(T reading) {
+
+	// Bits where the reading differs from the debounced state
+	const T delta = reading ^ currentState;
+
+	// Increment the counters of these bits, and reset all others
+	counterHigh = (counterHigh ^ counterLow) & delta;
+	counterLow = ~counterLow & delta;
+
+	// Counters which rolled over back to zero change state
+	const T toggle = delta & ~(counterHigh | counterLow);
+	currentState ^= toggle;
+	changeDetected |= toggle;
+
+	return currentState;
+}
+
+
+/**
+ * Read the current state of all buttons
+ *
+ * @return Debounced button states
+ */
+template <typename T>
+T PortDebounce<T>::read() {
+	return currentState;
+}
+
+
+/**
+ * Read the current state of one button
+ *
+ * @param  bit The bit number of the button
+ * @return Debounced button state
+ */
+template <typename T>
+bool PortDebounce<T>::read(uint8_t bit) {
+	return (currentState >> bit) & 1;
+}
+
+
+/**
+ * Check which buttons have changed state
+ *
+ * @return Bits set for every button with a rising/falling edge
+ */
+template <typename T>
+T PortDebounce<T>::onChange() {
+	const T changes = changeDetected;
+	changeDetected = 0;
+	return changes;
+}
+
+
+/**
+ * Check which buttons had a rising edge
+ *
+ * @return Bits set for every button with a rising edge
+ */
+template <typename T>
+T PortDebounce<T>::onRisingEdge() {
+	const T edges = changeDetected & currentState;
+	changeDetected &= ~edges;
+	return edges;
+}
+
+
+/**
+ * Check which buttons had a falling edge
+ *
+ * @return Bits set for every button with a falling edge
+ */
+template <typename T>
+T PortDebounce<T>::onFallingEdge() {
+	const T edges = changeDetected & ~currentState;
+	changeDetected &= ~edges;
+	return edges;
+}
+
+#endif /* PORT_DEBOUNCE_HPP */
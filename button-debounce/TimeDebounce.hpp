@@ -7,8 +7,8 @@
  * @website   https://wired.chillibasket.com/
  *
  * @copyright Copyright (C) 2021 - MIT License
- * @date      6th February 2021
- * @version   1.1
+ * @date      18th October 2026
+ * @version   1.2
  *
  * Based on the Debounce Class by wkoch:
  * https://github.com/wkoch/Debounce
@@ -20,8 +20,27 @@
 // Required for millis()
 #include <Arduino.h>
 
+/**
+ * Uncomment the next line to use the interrupt mode. Instead of calling
+ * "update()" continuously, call "interruptSignal()" from a pin change
+ * interrupt. The interrupt only saves the time of the edge, and the
+ * debounce decision is made the next time the state is checked. While
+ * the button is not moving, nothing needs to be done, so the Arduino
+ * can sleep between button presses. For example:
+ *
+ *   void buttonISR() { button.interruptSignal(); }
+ *   attachInterrupt(digitalPinToInterrupt(2), buttonISR, CHANGE);
+ *
+ * The interrupt mode saves and restores the AVR status register (SREG)
+ * around its critical sections, so it is only available on AVR boards.
+ */
+//#define TIME_DEBOUNCE_INTERRUPTS
 
-// Struct used to pack boolean bits
+
+// Struct used to pack boolean bits. The bits share one word, so
+// setting one rewrites the others. In interrupt mode, they are only
+// changed with interrupts disabled, so that "update()" can also be
+// called from a timer interrupt.
 struct TimeDebounceFlags {
 	unsigned currentState   :  1;
 	unsigned changeDetected :  1;
@@ -55,7 +74,18 @@ public:
 	uint16_t count();
 	void reset();
 
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		// Call from the pin change interrupt
+		void interruptSignal();
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
 private:
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		void evaluate();
+		volatile unsigned long edgeTime;
+		volatile bool edgePending;
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
 	unsigned long debounceTimer;
 	const uint8_t buttonPin;
 	const uint16_t debounceDelay;
@@ -102,38 +132,48 @@ void TimeDebounce::begin(bool enablePullup) {
 	flags.waiting = false;
 	flags.changeCounter = 0;
 	flags.changeDetected = false;
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		edgeTime = 0;
+		edgePending = false;
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
 }
 
 
 /**
  * Update Button State
  *
+ * In interrupt mode, the pin is only read if an edge was detected.
+ *
  * @return Current state after applying debounce
  */
 bool TimeDebounce::update() {
 
-	const bool readState = digitalRead(buttonPin);
-
-	// For each change of state
-	if (readState != flags.currentState) {
-
-		// Start the debounce timer
-		if (!flags.waiting) {
-			debounceTimer = millis();
-			flags.waiting = true;
-
-		// If reading stayed the same during debounce, update the state
-		} else if (millis() - debounceTimer > debounceDelay) {
-			flags.currentState = readState;
-			flags.changeDetected = true;
-			flags.changeCounter++;
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		evaluate();
+	#else
+		const bool readState = digitalRead(buttonPin);
+
+		// For each change of state
+		if (readState != flags.currentState) {
+
+			// Start the debounce timer
+			if (!flags.waiting) {
+				debounceTimer = millis();
+				flags.waiting = true;
+
+			// If reading stayed the same during debounce, update the state
+			} else if (millis() - debounceTimer > debounceDelay) {
+				flags.currentState = readState;
+				flags.changeDetected = true;
+				flags.changeCounter++;
+				flags.waiting = false;
+			}
+
+		// If debounce was active but state reverted, reset the timer
+		} else {
 			flags.waiting = false;
 		}
-
-	// If debounce was active but state reverted, reset the timer
-	} else {
-		flags.waiting = false;
-	}
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
 
 	return flags.currentState;
 }
@@ -145,6 +185,10 @@ bool TimeDebounce::update() {
  * @return Debounced button State
  */
 bool TimeDebounce::read() {
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		evaluate();
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
 	return flags.currentState;
 }
 
@@ -155,11 +199,20 @@ bool TimeDebounce::read() {
  * @return True on rising/falling edge, false otherwise
  */
 bool TimeDebounce::onChange() {
-	if (flags.changeDetected) {
-		flags.changeDetected = false;
-		return true;
-	}
-	return false;
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		evaluate();
+		uint8_t oldSREG = SREG;
+		cli();
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
+	const bool detected = flags.changeDetected;
+	if (detected) flags.changeDetected = false;
+
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		SREG = oldSREG;
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
+	return detected;
 }
 
 
@@ -169,11 +222,20 @@ bool TimeDebounce::onChange() {
  * @return True if rising edge detected
  */
 bool TimeDebounce::onRisingEdge() {
-	if (flags.currentState && flags.changeDetected) {
-		flags.changeDetected = false;
-		return true;
-	}
-	return false;
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		evaluate();
+		uint8_t oldSREG = SREG;
+		cli();
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
+	const bool detected = flags.currentState && flags.changeDetected;
+	if (detected) flags.changeDetected = false;
+
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		SREG = oldSREG;
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
+	return detected;
 }
 
 
@@ -183,11 +245,20 @@ bool TimeDebounce::onRisingEdge() {
  * @return True if falling edge detected
  */
 bool TimeDebounce::onFallingEdge() {
-	if (!flags.currentState && flags.changeDetected) {
-		flags.changeDetected = false;
-		return true;
-	}
-	return false;
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		evaluate();
+		uint8_t oldSREG = SREG;
+		cli();
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
+	const bool detected = !flags.currentState && flags.changeDetected;
+	if (detected) flags.changeDetected = false;
+
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		SREG = oldSREG;
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
+	return detected;
 }
 
 
@@ -197,6 +268,10 @@ bool TimeDebounce::onFallingEdge() {
  * @return The number of full button press & releases
  */
 uint16_t TimeDebounce::count() {
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		evaluate();
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
 	// Counter records presses and releases, so divide by 2
 	return flags.changeCounter / 2;
 }
@@ -206,8 +281,68 @@ uint16_t TimeDebounce::count() {
  * Reset the button click counter
  */
 void TimeDebounce::reset() {
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		uint8_t oldSREG = SREG;
+		cli();
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+
 	// Set counter to 1 if button is currently pressed, 0 otherwise
 	flags.changeCounter = !flags.currentState;
+
+	#ifdef TIME_DEBOUNCE_INTERRUPTS
+		SREG = oldSREG;
+	#endif /* TIME_DEBOUNCE_INTERRUPTS */
+}
+
+
+#ifdef TIME_DEBOUNCE_INTERRUPTS
+/**
+ * Pin change interrupt service routine (ISR)
+ *
+ * Only saves the time of the latest edge; all other
+ * calculations are done later by "evaluate()"
+ */
+void TimeDebounce::interruptSignal() {
+	edgeTime = millis();
+	edgePending = true;
+}
+
+
+/**
+ * Update the button state after an edge was detected
+ *
+ * If no new edges occurred during the debounce time, the signal
+ * has settled, so the pin is read and the state is updated.
+ * Nothing needs to be done while the button is not moving.
+ */
+void TimeDebounce::evaluate() {
+	if (!edgePending) return;
+
+	// Interrupts are disabled while reading the edge time, since
+	// it is 4 bytes long and could be changed by the ISR
+	uint8_t oldSREG = SREG;
+	cli();
+	const unsigned long lastEdge = edgeTime;
+	SREG = oldSREG;
+
+	if (millis() - lastEdge <= debounceDelay) return;
+
+	// Only clear the flag if no new edge occurred in the meantime.
+	// The state flags are updated in the same critical section, as
+	// they share one word with the flags cleared by the main loop
+	oldSREG = SREG;
+	cli();
+	if (edgeTime == lastEdge) edgePending = false;
+
+	const bool readState = digitalRead(buttonPin);
+	if (readState != flags.currentState) {
+		flags.currentState = readState;
+		flags.changeDetected = true;
+		flags.changeCounter++;
+	}
+
+	SREG = oldSREG;
 }
+#endif /* TIME_DEBOUNCE_INTERRUPTS */
 
 #endif /* TIME_DEBOUNCE_HPP */
\ No newline at end of file
@@ -0,0 +1,146 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Bounce Trace Replay Sketch
+ *
+ * @file      bounce-trace.ino
+ * @brief     Compare debounce settings using simulated button signals
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * @see       <BitDebounce.hpp>
+ *
+ * A longer bit history ignores longer bounces, but also takes
+ * longer to detect a change. This sketch helps to pick the right
+ * settings, by replaying the same signal traces through several
+ * versions of the BasicBitDebounce class.
+ *
+ * Each trace contains a number of presses and releases. After each
+ * edge the signal bounces randomly for a number of samples (short
+ * for tactile switches, longer for relays and reed switches), and
+ * while the signal is stable there are occasional one-sample spikes.
+ * The same random seed is used for every class, so they all receive
+ * exactly the same readings. To test with a recorded signal, replace
+ * the function "traceSample()" with one which returns your readings.
+ *
+ * The results are printed as CSV:
+ * switch, history bits, stable, prior, edges, missed, false edges,
+ * average latency (samples from the real edge to the detected change)
+ *
+ * @note      Copy "BitDebounce.hpp" from the parent folder
+ *            into the folder of this sketch
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "BitDebounce.hpp"
+
+#define TRACE_EDGES    200   // Number of presses + releases in each trace
+#define STABLE_SAMPLES 100   // Samples between the edges
+#define SPIKE_CHANCE   50    // One in this many stable samples is a spike
+#define TRACE_SEED     1234  // Random seed, so that all classes get the same trace
+
+
+/**
+ * Get the next sample of the simulated trace
+ *
+ * @param  level  The real state of the button
+ * @param  since  Number of samples since the last real edge
+ * @param  bounce Number of samples during which the signal bounces
+ * @return The reading of the button
+ */
+bool traceSample(bool level, uint16_t since, uint8_t bounce) {
+	if (since < bounce) return random(0, 2);
+	if (random(0, SPIKE_CHANCE) == 0) return !level;
+	return level;
+}
+
+
+/**
+ * Replay a trace through one debounce class and print the results
+ *
+ * @param  name   Name of the switch type
+ * @param  bounce Number of samples during which the signal bounces
+ */
+template <typename Debouncer>
+void replay(const char *name, uint8_t bounce) {
+	Debouncer button(0);
+	button.setState(false);
+	randomSeed(TRACE_SEED);
+
+	bool level = false;
+	bool matched = true;
+	uint16_t missed = 0;
+	uint16_t falseEdges = 0;
+	unsigned long totalLatency = 0;
+	unsigned long index = 0;
+
+	for (uint16_t edge = 0; edge < TRACE_EDGES; edge++) {
+
+		// Change the real state of the button
+		if (!matched) missed++;
+		level = !level;
+		matched = false;
+
+		for (uint16_t since = 0; since < STABLE_SAMPLES; since++, index++) {
+			button.update(traceSample(level, since, bounce));
+
+			// The first change to the real state is counted as the detected
+			// edge; any other changes are counted as false edges
+			if (button.onChange()) {
+				if (button.read() == level && !matched) {
+					matched = true;
+					totalLatency += since;
+				} else {
+					falseEdges++;
+				}
+			}
+		}
+	}
+	if (!matched) missed++;
+
+	Serial.print(name); Serial.print(",");
+	Serial.print((int) Debouncer::bits()); Serial.print(",");
+	Serial.print(__builtin_popcountl(Debouncer::stableMask())); Serial.print(",");
+	Serial.print(__builtin_popcountl(Debouncer::priorMask())); Serial.print(",");
+	Serial.print(TRACE_EDGES); Serial.print(",");
+	Serial.print(missed); Serial.print(",");
+	Serial.print(falseEdges); Serial.print(",");
+	Serial.println(totalLatency / float(TRACE_EDGES - missed), 1);
+}
+
+
+/**
+ * Replay one type of switch through all of the debounce settings
+ *
+ * @param  name   Name of the switch type
+ * @param  bounce Number of samples during which the signal bounces
+ */
+void replayAll(const char *name, uint8_t bounce) {
+	replay<BitDebounce>(name, bounce);
+	replay<BasicBitDebounce<uint16_t, 4, 4> >(name, bounce);
+	replay<BasicBitDebounce<uint16_t, 6, 8> >(name, bounce);
+	replay<BasicBitDebounce<uint32_t, 10, 10> >(name, bounce);
+}
+
+
+/**
+ * Setup Code
+ */
+void setup() {
+	Serial.begin(9600);
+	while(!Serial);
+
+	Serial.println("switch,bits,stable,prior,edges,missed,false_edges,latency");
+	replayAll("tactile", 4);
+	replayAll("relay", 12);
+	replayAll("reed", 25);
+}
+
+
+/**
+ * Main Program Loop
+ */
+void loop() {
+	// Empty
+}
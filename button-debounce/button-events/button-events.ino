@@ -0,0 +1,100 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Button Events Example Sketch
+ *
+ * @file      button-events.ino
+ * @brief     Detect button gestures and handle them from an event queue
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * @see       <ButtonEvents.hpp>
+ * @see       <BitDebounce.hpp>
+ *
+ * Two buttons are debounced and checked for gestures inside a
+ * 200Hz timer interrupt (Timer2 with a prescale of 1024 and a
+ * compare value of 77, so 200.3Hz). A new state is accepted after 3
+ * stable samples (15ms). The events (press, release, long press,
+ * repeat and multi-clicks) are saved into a shared queue, which
+ * the main loop reads whenever it has time. Even if the main loop
+ * is slow (simulated using a delay), no events are lost.
+ *
+ * @note      Copy "BitDebounce.hpp" and "ButtonEvents.hpp" from the
+ *            parent folder, and "setupTimers.h" from the folder
+ *            "timer-interrupts" into the folder of this sketch
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "BitDebounce.hpp"
+#include "ButtonEvents.hpp"
+#include "setupTimers.h"
+
+/* Create button objects */
+BitDebounce button2( 2 );
+BitDebounce button3( 3 );
+
+// All buttons save their events into the same queue
+ButtonEventQueue events;
+// (Queue, Button ID)
+ButtonEvents gestures2( events, 2 );
+ButtonEvents gestures3( events, 3 );
+
+const char *eventNames[] = {"None", "Press", "Release", "Long press", "Repeat", "Click"};
+
+
+/**
+ * Timer 2 Interrupt Service Routine
+ * Update the buttons at regular intervals
+ */
+ISR(TIMER2_COMPA_vect) {
+	gestures2.update(button2.update());
+	gestures3.update(button3.update());
+}
+
+
+/**
+ * Setup Code
+ */
+void setup() {
+	Serial.begin(9600);
+
+	button2.begin( true );
+	button3.begin( true );
+
+	// Button 3 does not repeat while held
+	gestures3.setTimings(1000, 0, 300);
+
+	setupTimer2(200);
+}
+
+
+/**
+ * Main Program Loop
+ */
+void loop() {
+
+	// Handle all events which happened since the last loop
+	struct ButtonEvent event;
+	while (events.pop(event)) {
+		Serial.print(event.time);
+		Serial.print(" ms - Button ");
+		Serial.print(event.button);
+		Serial.print(": ");
+		Serial.print(eventNames[event.type]);
+
+		if (event.type == event_click) {
+			Serial.print(" x");
+			Serial.print(event.clicks);
+		}
+		Serial.println();
+	}
+
+	if (events.overflows() > 0) {
+		Serial.println("Warning: events were lost, increase BUTTON_EVENTS_QUEUE_SIZE");
+		events.clear();
+	}
+
+	// Simulate other slow tasks
+	delay(100);
+}
@@ -0,0 +1,76 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Debounce Scheduler Example Sketch
+ *
+ * @file      debounce-scheduler.ino
+ * @brief     Debounce 12 buttons from one timer interrupt
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * @see       <DebounceScheduler.hpp>
+ *
+ * All buttons are updated together by a 1kHz timer interrupt (Timer2
+ * with a prescale of 64 and a compare value of 249), and need to be
+ * stable for 20 ticks (20ms) before their state changes.
+ * The main loop reads the states of all buttons at once, without
+ * having to call millis() or update each button separately.
+ *
+ * @note      Copy "DebounceScheduler.hpp" from the parent folder,
+ *            and "setupTimers.h" from the folder "timer-interrupts"
+ *            into the folder of this sketch
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "DebounceScheduler.hpp"
+#include "setupTimers.h"
+
+#define NUMBER_OF_BUTTONS 12
+
+const uint8_t buttonPins[NUMBER_OF_BUTTONS] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, A0};
+
+// (Debounce time in ticks)
+DebounceScheduler<NUMBER_OF_BUTTONS> buttons( 20 );
+
+
+/**
+ * Timer 2 Interrupt Service Routine
+ * Update all of the buttons
+ */
+ISR(TIMER2_COMPA_vect) {
+	buttons.tick();
+}
+
+
+/**
+ * Setup Code
+ */
+void setup() {
+	Serial.begin(9600);
+
+	buttons.begin(buttonPins, true);
+	setupTimer2(1000);
+}
+
+
+/**
+ * Main Program Loop
+ */
+void loop() {
+
+	// Check all buttons for edges at the same time
+	uint32_t changes = buttons.onChange();
+
+	if (changes) {
+		uint32_t states = buttons.snapshot();
+
+		for (uint8_t i = 0; i < NUMBER_OF_BUTTONS; i++) {
+			if ((changes >> i) & 1) {
+				Serial.print("Button on pin ");
+				Serial.print(buttonPins[i]);
+				Serial.println(((states >> i) & 1)? " released" : " pressed");
+			}
+		}
+	}
+}
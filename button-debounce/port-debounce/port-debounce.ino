@@ -0,0 +1,136 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Port-wide Debounce Example Sketch
+ *
+ * @file      port-debounce.ino
+ * @brief     Debounce 18 buttons at the same time using whole port readings
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * @see       <PortDebounce.hpp>
+ * @see       <BitDebounce.hpp>
+ *
+ * This sketch is written for the Arduino Uno (ATmega328P). It reads
+ * the PIND, PINB and PINC registers directly and combines them into
+ * one 32-bit number, so that all 18 available pins (D2-D13, A0-A5)
+ * are debounced by one call to "update()".
+ *
+ * At the start, the speed is compared against updating 18 separate
+ * BitDebounce objects, which each call "digitalRead()".
+ *
+ * @note      Copy "PortDebounce.hpp" and "BitDebounce.hpp" from
+ *            the parent folder into the folder of this sketch
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "PortDebounce.hpp"
+#include "BitDebounce.hpp"
+
+#define NUMBER_OF_BUTTONS 18
+#define BENCHMARK_LOOPS 1000
+
+// Pins in the same order as the bits of "readButtons()"
+const uint8_t buttonPins[NUMBER_OF_BUTTONS] = { 2,  3,  4,  5,  6,  7,
+                                                8,  9, 10, 11, 12, 13,
+                                               A0, A1, A2, A3, A4, A5};
+
+// Names of the bits, for printing the results
+const char *buttonNames[NUMBER_OF_BUTTONS] = {"D2", "D3", "D4", "D5", "D6", "D7",
+                                              "D8", "D9", "D10", "D11", "D12", "D13",
+                                              "A0", "A1", "A2", "A3", "A4", "A5"};
+
+// One object debounces all of the buttons
+PortDebounce<uint32_t> buttons;
+
+// Separate objects for each button, used for the benchmark
+BitDebounce bitButtons[NUMBER_OF_BUTTONS] = { 2,  3,  4,  5,  6,  7,
+                                              8,  9, 10, 11, 12, 13,
+                                             A0, A1, A2, A3, A4, A5};
+
+unsigned long loopTimer = 0;
+
+
+/**
+ * Read all of the buttons at once
+ *
+ * @return One bit per button: D2-D7 in bits 0-5, D8-D13
+ *         in bits 6-11, and A0-A5 in bits 12-17
+ */
+uint32_t readButtons() {
+	return (uint32_t) (PIND >> 2)
+		| ((uint32_t) (PINB & 0x3F) << 6)
+		| ((uint32_t) (PINC & 0x3F) << 12);
+}
+
+
+/**
+ * Compare the time needed to update all buttons
+ */
+void benchmark() {
+	unsigned long stopwatch = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		buttons.update(readButtons());
+	}
+	unsigned long portTime = micros() - stopwatch;
+
+	stopwatch = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		for (uint8_t j = 0; j < NUMBER_OF_BUTTONS; j++) bitButtons[j].update();
+	}
+	unsigned long bitTime = micros() - stopwatch;
+
+	Serial.print("PortDebounce, all buttons (us): ");
+	Serial.println(portTime / float(BENCHMARK_LOOPS));
+	Serial.print("BitDebounce, all buttons (us): ");
+	Serial.println(bitTime / float(BENCHMARK_LOOPS));
+}
+
+
+/**
+ * Setup Code
+ */
+void setup() {
+	Serial.begin(9600);
+
+	// Enable the pullups on all button pins
+	for (uint8_t i = 0; i < NUMBER_OF_BUTTONS; i++) {
+		bitButtons[i].begin(true);
+	}
+
+	// Start with the current state of the buttons
+	buttons.begin(readButtons());
+
+	benchmark();
+}
+
+
+/**
+ * Main Program Loop
+ */
+void loop() {
+
+	// Run this code every 5ms (200Hz)
+	if (millis() - loopTimer >= 5) {
+		loopTimer = millis();
+
+		buttons.update(readButtons());
+
+		// Check all buttons for edges at the same time
+		uint32_t pressed = buttons.onFallingEdge();
+		uint32_t released = buttons.onRisingEdge();
+
+		if (pressed | released) {
+			for (uint8_t i = 0; i < NUMBER_OF_BUTTONS; i++) {
+				if ((pressed >> i) & 1) {
+					Serial.print("Pressed: ");
+					Serial.println(buttonNames[i]);
+				} else if ((released >> i) & 1) {
+					Serial.print("Released: ");
+					Serial.println(buttonNames[i]);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,288 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Multiple Rotary Encoder Manager Class Header File
+ *
+ * @file      EncoderManager.hpp
+ * @brief     Count the steps of up to 8 encoders using pin change interrupts
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * The RotaryEncoder class uses "attachInterrupt()", and the Arduino
+ * Uno only has two external interrupt pins. This class uses the pin
+ * change interrupts instead, which are available on all pins, but
+ * where each group of pins (one port) shares the same interrupt:
+ *   PCINT0_vect = pins 8-13, PCINT1_vect = A0-A5, PCINT2_vect = 0-7
+ *
+ * The interrupt of each group reads its port register once, and the
+ * last value of every port is saved. Each encoder whose pins changed
+ * is then updated using the transition table in "RotaryEncoder.hpp",
+ * so the two pins of an encoder can even be on different ports.
+ *
+ * The positions of all encoders can be copied at once using
+ * "snapshot()", without disabling the interrupts. The positions are
+ * counted in quadrature steps (four steps per encoder cycle).
+ *
+ * @note Written for the ATmega328 (Uno/Nano), where each pin change
+ *       group matches one port.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ENCODER_MANAGER_HPP
+#define ENCODER_MANAGER_HPP
+
+// Required for the transition table
+#include "RotaryEncoder.hpp"
+
+/**
+ * Number of pin change interrupt groups
+ */
+#define ENCODER_MANAGER_GROUPS 3
+
+
+/**
+ * @class EncoderManager
+ *
+ * @tparam N The number of encoders (up to 8)
+ */
+template <uint8_t N>
+class EncoderManager {
+public:
+	// Constructor
+	EncoderManager();
+
+	// Initialise the pins and enable the pin change interrupts
+	bool begin(const uint8_t (&pinsA)[N], const uint8_t (&pinsB)[N], bool enablePullup = false);
+
+	// Called from the pin change interrupt of a group
+	void interruptSignal(uint8_t group);
+
+	// Functions to read the positions
+	void snapshot(int32_t (&positions)[N]);
+	int32_t getCount(uint8_t encoder);
+	uint16_t getInvalidCount(uint8_t encoder);
+	void reset();
+
+	static_assert(N > 0 && N <= 8, "EncoderManager supports 1 to 8 encoders");
+
+private:
+	uint8_t readState(uint8_t encoder);
+
+	// Pin change group and bit mask of the pins of each encoder
+	uint8_t groupA[N];
+	uint8_t groupB[N];
+	uint8_t maskA[N];
+	uint8_t maskB[N];
+
+	// Port input register and last value of each group
+	volatile uint8_t *groupInput[ENCODER_MANAGER_GROUPS];
+	uint8_t groupValue[ENCODER_MANAGER_GROUPS];
+
+	// Shared with the interrupts
+	uint8_t lastState[N];
+	volatile int32_t stepCounter[N];
+	volatile uint16_t invalidCounter[N];
+	volatile uint8_t sequence;
+};
+
+
+/**
+ * Constructor
+ */
+template <uint8_t N>
+EncoderManager<N>::EncoderManager()
+	: sequence(0)
+{
+	for (uint8_t i = 0; i < N; i++) {
+		stepCounter[i] = 0;
+		invalidCounter[i] = 0;
+	}
+
+	for (uint8_t i = 0; i < ENCODER_MANAGER_GROUPS; i++) {
+		groupInput[i] = NULL;
+		groupValue[i] = 0;
+	}
+}
+
+
+/**
+ * Initialise the encoder pins and enable their pin change interrupts
+ *
+ * The interrupt functions of the groups need to be defined in the sketch:
+ *   ISR(PCINT0_vect) { encoders.interruptSignal(0); }
+ *   ISR(PCINT1_vect) { encoders.interruptSignal(1); }
+ *   ISR(PCINT2_vect) { encoders.interruptSignal(2); }
+ *
+ * @param  pinsA         Array containing the A signal pin of each encoder
+ * @param  pinsB         Array containing the B signal pin of each encoder
+ * @param  enablePullup  Whether to enable the internal pullups (default = false)
+ * @return True if successful, false if a pin has no pin change interrupt
+ */
+template <uint8_t N>
+bool EncoderManager<N>::begin(const uint8_t (&pinsA)[N], const uint8_t (&pinsB)[N], bool enablePullup) {
+
+	// Check all pins before changing any settings
+	for (uint8_t i = 0; i < N; i++) {
+		if (digitalPinToPCICR(pinsA[i]) == NULL || digitalPinToPCICRbit(pinsA[i]) >= ENCODER_MANAGER_GROUPS) return false;
+		if (digitalPinToPCICR(pinsB[i]) == NULL || digitalPinToPCICRbit(pinsB[i]) >= ENCODER_MANAGER_GROUPS) return false;
+	}
+
+	uint8_t oldSREG = SREG;
+	cli();
+
+	for (uint8_t i = 0; i < N; i++) {
+		const uint8_t pins[2] = {pinsA[i], pinsB[i]};
+
+		for (uint8_t j = 0; j < 2; j++) {
+			const uint8_t group = digitalPinToPCICRbit(pins[j]);
+			pinMode(pins[j], (enablePullup)? INPUT_PULLUP : INPUT);
+			groupInput[group] = portInputRegister(digitalPinToPort(pins[j]));
+			*digitalPinToPCMSK(pins[j]) |= 1 << digitalPinToPCMSKbit(pins[j]);
+		}
+
+		groupA[i] = digitalPinToPCICRbit(pinsA[i]);
+		groupB[i] = digitalPinToPCICRbit(pinsB[i]);
+		maskA[i] = digitalPinToBitMask(pinsA[i]);
+		maskB[i] = digitalPinToBitMask(pinsB[i]);
+	}
+
+	// Save the current value of the ports and the state of the encoders
+	for (uint8_t group = 0; group < ENCODER_MANAGER_GROUPS; group++) {
+		if (groupInput[group] != NULL) {
+			groupValue[group] = *groupInput[group];
+			PCIFR = 1 << group;
+			PCICR |= 1 << group;
+		}
+	}
+
+	for (uint8_t i = 0; i < N; i++) {
+		lastState[i] = readState(i);
+	}
+
+	SREG = oldSREG;
+	return true;
+}
+
+
+/**
+ * Pin change interrupt service routine (ISR)
+ *
+ * @param  group The pin change group which triggered the interrupt
+ *               (0 for PCINT0_vect, 1 for PCINT1_vect, 2 for PCINT2_vect)
+ */
+template <uint8_t N>
+void EncoderManager<N>::interruptSignal(uint8_t group) {
+
+	// Read the port once, and find which pins changed
+	const uint8_t value = *groupInput[group];
+	const uint8_t changed = value ^ groupValue[group];
+	groupValue[group] = value;
+
+	sequence++;
+
+	for (uint8_t i = 0; i < N; i++) {
+		if ((groupA[i] == group && (changed & maskA[i])) || (groupB[i] == group && (changed & maskB[i]))) {
+			const uint8_t state = readState(i);
+			const int8_t step = encoderTransitions[(lastState[i] << 2) | state];
+
+			if (step == ENCODER_INVALID) invalidCounter[i]++;
+			else stepCounter[i] += step;
+
+			lastState[i] = state;
+		}
+	}
+
+	sequence++;
+}
+
+
+/**
+ * Copy the positions of all encoders
+ *
+ * If an interrupt updates the positions while they are being copied,
+ * the copy is repeated, so all positions are from the same moment.
+ *
+ * @param[out] positions Array into which the position of each encoder is copied
+ */
+template <uint8_t N>
+void EncoderManager<N>::snapshot(int32_t (&positions)[N]) {
+	uint8_t start;
+
+	do {
+		start = sequence;
+		for (uint8_t i = 0; i < N; i++) positions[i] = stepCounter[i];
+	} while ((start & 1) || start != sequence);
+}
+
+
+/**
+ * Get the position of one encoder
+ *
+ * @param  encoder The number of the encoder (position in the pin arrays)
+ * @return The number of steps
+ */
+template <uint8_t N>
+int32_t EncoderManager<N>::getCount(uint8_t encoder) {
+	uint8_t start;
+	int32_t currentCount;
+
+	do {
+		start = sequence;
+		currentCount = stepCounter[encoder];
+	} while ((start & 1) || start != sequence);
+
+	return currentCount;
+}
+
+
+/**
+ * Count how many invalid transitions have occurred on one encoder
+ *
+ * @param  encoder The number of the encoder (position in the pin arrays)
+ * @return The number of invalid transitions
+ */
+template <uint8_t N>
+uint16_t EncoderManager<N>::getInvalidCount(uint8_t encoder) {
+	uint8_t start;
+	uint16_t currentCount;
+
+	do {
+		start = sequence;
+		currentCount = invalidCounter[encoder];
+	} while ((start & 1) || start != sequence);
+
+	return currentCount;
+}
+
+
+/**
+ * Reset the positions and invalid counts of all encoders
+ */
+template <uint8_t N>
+void EncoderManager<N>::reset() {
+	uint8_t oldSREG = SREG;
+	cli();
+
+	for (uint8_t i = 0; i < N; i++) {
+		stepCounter[i] = 0;
+		invalidCounter[i] = 0;
+	}
+
+	SREG = oldSREG;
+}
+
+
+/**
+ * Get the state of an encoder from the last values of the ports
+ *
+ * @param  encoder The number of the encoder
+ * @return The state of the signals: (A << 1) | B
+ */
+template <uint8_t N>
+inline uint8_t EncoderManager<N>::readState(uint8_t encoder) {
+	return ((groupValue[groupA[encoder]] & maskA[encoder])? 2 : 0)
+	     | ((groupValue[groupB[encoder]] & maskB[encoder])? 1 : 0);
+}
+
+#endif /* ENCODER_MANAGER_HPP */
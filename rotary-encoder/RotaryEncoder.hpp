@@ -7,10 +7,57 @@
  * @website   https://wired.chillibasket.com/
  *
  * @copyright Copyright (C) 2020 - MIT License
- * @date      16th January 2021
- * @version   0.2
+ * @date      18th October 2026
+ * @version   0.5
  *
  * This class is still a work in progress!
+ *
+ * The encoder pins are read directly from the port input registers,
+ * and in the "sig_ab_change" mode the step is found using a 16-entry
+ * table of the transitions between the previous and new states of
+ * the signals. Transitions where both signals changed at once are
+ * invalid (an edge was missed) and are counted separately.
+ *
+ * For the highest count rates, use the "FastRotaryEncoder" template,
+ * where the trigger type is fixed at compile time and the debug
+ * counter is removed. On a 16MHz Arduino Uno, its interrupt takes
+ * roughly 100 clock cycles including the "attachInterrupt()" overhead.
+ * This is an estimate from counting the instructions of the generated
+ * code, not a measurement, but it suggests a limit of about 100,000
+ * edges per second on a single encoder. Close to this rate, the main
+ * program stops running and edges start to be missed; check
+ * "getInvalidCount()" to detect this.
+ *
+ * The counts are stored as 32-bit numbers, so they do not overflow
+ * after a few revolutions of a motor. Reading a 32-bit number takes
+ * several instructions on an 8-bit microcontroller, so the interrupt
+ * increments a sequence counter before and after it changes any of
+ * the values (making it odd while writing). The functions which read
+ * the counts repeat the copy if the sequence changed, so they never
+ * need to disable the interrupts.
+ *
+ * For mechanical encoders, contact bounce can trigger a burst of
+ * interrupts which delays other interrupts. In the "sig_polled" mode
+ * no pin interrupts are used; instead "pollSignal()" is called from a
+ * timer interrupt at a fixed rate. A new state of the signals is only
+ * accepted once it has been read on several samples in a row (glitch
+ * filter), and is then decoded using the transition table. While the
+ * encoder is not moving, samples are skipped so that the sample rate
+ * drops step by step; as soon as a change is seen it returns to the
+ * full rate. The time spent in each tick is therefore always short,
+ * no matter how much the contacts bounce.
+ *
+ * By uncommenting "#define ROTARY_ENCODER_TIMESTAMPS", the time of the
+ * latest edge is also saved in the interrupt, and "getVelocity()" can
+ * be used to estimate the speed. This uses the "M/T" method: the change
+ * in count since the last estimate is divided by the time between the
+ * edges at the start and end of that window (not by the time between
+ * the function calls). At high speeds many edges are counted within
+ * the window, while at low speeds it becomes the inverse of the time
+ * between two edges (1/T). If no edge arrives, the speed decays based
+ * on the time since the last edge, and is zero after a timeout.
+ * Calling "micros()" adds a few microseconds to each interrupt, which
+ * lowers the maximum count rate.
  * * * * * * * * * * * * * * * * * * * * * * */
 
 #ifndef ROTARY_ENCODER_HPP
@@ -18,13 +65,55 @@
 
 #include <Arduino.h>
 
+/**
+ * Uncomment to save the time of each edge, for velocity estimation
+ */
+//#define ROTARY_ENCODER_TIMESTAMPS
+
+#ifdef ROTARY_ENCODER_TIMESTAMPS
+	// Default minimum time between velocity estimates (microseconds)
+	#define ROTARY_ENCODER_VELOCITY_WINDOW 10000
+
+	// Default time without edges before the velocity is zero (microseconds)
+	#define ROTARY_ENCODER_VELOCITY_TIMEOUT 500000
+#endif /* ROTARY_ENCODER_TIMESTAMPS */
+
+// Default number of samples a new state needs to be read before it is accepted
+#define ROTARY_ENCODER_POLL_FILTER 2
+
+// Default maximum number of ticks between samples while the encoder is not moving
+#define ROTARY_ENCODER_POLL_DIVIDER 8
+
+// Number of samples without any changes before the sample rate is halved
+#define ROTARY_ENCODER_POLL_IDLE 32
+
 /**
  * Define the valid interrupt trigger types
  */
 enum trigger_t {
 	sig_a_rising = 0,
 	sig_a_change = 1,
-	sig_ab_change = 2
+	sig_ab_change = 2,
+	sig_polled = 3
+};
+
+
+/**
+ * Value in the transition table for invalid transitions
+ */
+#define ENCODER_INVALID 2
+
+/**
+ * Step for each transition, indexed by (last state << 2) | new state,
+ * where the state of the signals is (A << 1) | B. The sequence
+ * 00 -> 10 -> 11 -> 01 -> 00 is a positive step.
+ */
+const int8_t encoderTransitions[16] = {
+	//  New:  00                01                10                11
+	/* 00 */  0,               -1,                1,                ENCODER_INVALID,
+	/* 01 */  1,                0,                ENCODER_INVALID, -1,
+	/* 10 */ -1,                ENCODER_INVALID,  0,                1,
+	/* 11 */  ENCODER_INVALID,  1,               -1,                0
 };
 
 
@@ -38,26 +127,72 @@ public:
 	~RotaryEncoder();
 
 	// Update button reading
-	int16_t update();
+	int32_t update();
 	void begin(void (interruptFunction)(void));
 
 	// Click counter functions
 	void reset();
-	int16_t getCount();
-	int16_t getCountDebug();
-	int16_t getCountAndReset();
+	int32_t getCount();
+	int32_t getCountDebug();
+	int32_t getCountAndReset();
+	uint16_t getInvalidCount();
 	uint16_t isrCounter;
 
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		// Velocity estimation
+		void setVelocityTimes(unsigned long window, unsigned long timeout);
+		float getVelocity();
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
+
 	void interruptSignal();
 
-private:
+	// Polled mode, called from a timer interrupt
+	void pollSignal();
+	void setPollFilter(uint8_t samples, uint8_t maxDivider);
+	uint8_t getPollDivider();
 
-	uint8_t scaleFactor;
-	volatile int16_t outputCounter;
-	volatile int16_t stepCounter;
+protected:
+	uint8_t readState();
+	void applyStep(int8_t step);
 
-	volatile bool lastStateA;
-	volatile bool lastStateB;
+	uint8_t scaleFactor;
+	volatile int32_t outputCounter;
+	volatile int32_t stepCounter;
+	volatile uint16_t invalidCounter;
+
+	// Incremented before and after the interrupt changes the counts
+	volatile uint8_t sequence;
+
+	// State of the polled mode
+	uint8_t filterSamples;
+	uint8_t maxPollDivider;
+	volatile uint8_t pollDivider;
+	uint8_t pollTicks;
+	uint8_t pollIdle;
+	uint8_t candidateState;
+	uint8_t candidateCount;
+
+	// State of the signals: (A << 1) | B
+	volatile uint8_t lastState;
+
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		// Time of the latest edge, saved by the interrupt
+		volatile unsigned long edgeTime;
+
+		// State of the velocity estimate
+		unsigned long velocityWindow;
+		unsigned long velocityTimeout;
+		unsigned long windowTime;
+		unsigned long windowEdgeTime;
+		int32_t windowCount;
+		float velocity;
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
+
+	// Port input registers and bit masks of the pins
+	volatile uint8_t *portA;
+	volatile uint8_t *portB;
+	uint8_t maskA;
+	uint8_t maskB;
 
 	const uint8_t signalPinA;
 	const uint8_t signalPinB;
@@ -74,6 +209,7 @@ private:
  * @param  pullup        Whether to enable the internal pullups [default=false]
  * @param  interruptType Specify on which edges to trigger an interrupt:
  *                       [sig_a_rising] [sig_a_change] [default=sig_ab_change]
+ *                       or use [sig_polled] to call pollSignal() from a timer
  * @param  scaling       Scale output depending on # of pulses per step [default=3]
  *
  * @note Using interrupts on both pins provides the highest resolution
@@ -88,13 +224,40 @@ RotaryEncoder::RotaryEncoder(uint8_t pinA, uint8_t pinB, bool pullup, enum trigg
 	, enablePullups(pullup)
 	, triggerType(interruptType)
 {
-	// Validate the scale factor
-	if (triggerType < scaling) scaleFactor = triggerType;
+	// Validate the scale factor; the polled mode counts every edge like sig_ab_change
+	const uint8_t maxScale = (triggerType == sig_polled)? sig_ab_change : triggerType;
+	if (maxScale < scaling) scaleFactor = maxScale;
 	else scaleFactor = scaling;
 
 	stepCounter = 0;
 	outputCounter = 0;
+	invalidCounter = 0;
 	isrCounter = 0;
+	lastState = 0;
+	sequence = 0;
+
+	filterSamples = ROTARY_ENCODER_POLL_FILTER;
+	maxPollDivider = ROTARY_ENCODER_POLL_DIVIDER;
+	pollDivider = 1;
+	pollTicks = 0;
+	pollIdle = 0;
+	candidateState = 0;
+	candidateCount = 0;
+
+	portA = portInputRegister(digitalPinToPort(signalPinA));
+	portB = portInputRegister(digitalPinToPort(signalPinB));
+	maskA = digitalPinToBitMask(signalPinA);
+	maskB = digitalPinToBitMask(signalPinB);
+
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		velocityWindow = ROTARY_ENCODER_VELOCITY_WINDOW;
+		velocityTimeout = ROTARY_ENCODER_VELOCITY_TIMEOUT;
+		edgeTime = 0;
+		windowTime = 0;
+		windowEdgeTime = 0;
+		windowCount = 0;
+		velocity = 0;
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
 }
 
 
@@ -112,14 +275,21 @@ RotaryEncoder::~RotaryEncoder() {
  * @param interruptFunction  The function to be called when an interrupt is triggered
  *                           This should always be: []{objectName.interruptSignal();}
  *                           If left blank, no interrupts will be used.
+ *                           In the sig_polled mode this is not used (NULL).
  */
 void RotaryEncoder::begin(void (interruptFunction)(void)) {
 
 	pinMode(signalPinA, (enablePullups)? INPUT_PULLUP : INPUT);
 	pinMode(signalPinB, (enablePullups)? INPUT_PULLUP : INPUT);
 
-	lastStateA = digitalRead(signalPinA);
-	lastStateB = digitalRead(signalPinB);
+	lastState = readState();
+	candidateState = lastState;
+
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		edgeTime = micros();
+		windowTime = edgeTime;
+		windowEdgeTime = edgeTime;
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
 
 	// Default case = no interrupts
 	switch (triggerType) {
@@ -131,6 +301,10 @@ void RotaryEncoder::begin(void (interruptFunction)(void)) {
 		case sig_a_change:
 			attachInterrupt(digitalPinToInterrupt(signalPinA), interruptFunction, CHANGE);
 			break;
+
+		// Polled mode: pollSignal() is called from a timer instead
+		case sig_polled:
+			break;
 	}
 }
 
@@ -141,7 +315,7 @@ void RotaryEncoder::begin(void (interruptFunction)(void)) {
  * @note   This should only be used if no interrupts are enabled
  * @return The current encoder step count
  */
-int16_t RotaryEncoder::update() {
+int32_t RotaryEncoder::update() {
 	interruptSignal();
 	return outputCounter;
 }
@@ -152,10 +326,16 @@ int16_t RotaryEncoder::update() {
  *
  * @return The number of steps
  */
-int16_t RotaryEncoder::getCount() {
-	cli();
-	uint16_t currentCount = outputCounter;	
-	sei();
+int32_t RotaryEncoder::getCount() {
+	uint8_t start;
+	int32_t currentCount;
+
+	// Repeat the copy if the interrupt changed the count meanwhile
+	do {
+		start = sequence;
+		currentCount = outputCounter;
+	} while ((start & 1) || start != sequence);
+
 	return currentCount;
 }
 
@@ -165,15 +345,24 @@ int16_t RotaryEncoder::getCount() {
  *
  * @return The number of steps
  */
-int16_t RotaryEncoder::getCountDebug() {
-	cli();
-	uint16_t currentCount = outputCounter;	
-	Serial.print(lastStateA); Serial.print(",");
-	Serial.print(lastStateB); Serial.print(" - int:");
-	Serial.print(stepCounter); Serial.print(" - out:");
-	Serial.print(outputCounter); Serial.print(" - isr:");
-	Serial.print(isrCounter); Serial.print(" - ");
-	sei();
+int32_t RotaryEncoder::getCountDebug() {
+	uint8_t start, state;
+	int32_t currentCount, currentSteps;
+	uint16_t currentIsr;
+
+	do {
+		start = sequence;
+		state = lastState;
+		currentSteps = stepCounter;
+		currentCount = outputCounter;
+		currentIsr = isrCounter;
+	} while ((start & 1) || start != sequence);
+
+	Serial.print(state >> 1); Serial.print(",");
+	Serial.print(state & 1); Serial.print(" - int:");
+	Serial.print(currentSteps); Serial.print(" - out:");
+	Serial.print(currentCount); Serial.print(" - isr:");
+	Serial.print(currentIsr); Serial.print(" - ");
 	return currentCount;
 }
 
@@ -183,13 +372,41 @@ int16_t RotaryEncoder::getCountDebug() {
  *
  * @return The number of steps
  */
-int16_t RotaryEncoder::getCountAndReset() {
+int32_t RotaryEncoder::getCountAndReset() {
+
+	// The count needs to be read and cleared without being interrupted
+	uint8_t oldSREG = SREG;
 	cli();
-	uint16_t currentCount = outputCounter;
-	outputCounter = 0;	
+	const int32_t currentCount = outputCounter;
+	outputCounter = 0;
 	stepCounter = 0;
-	sei();
-	return currentCount >> scaleFactor;
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		windowCount = 0;
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
+	SREG = oldSREG;
+
+	return currentCount;
+}
+
+
+/**
+ * Count how many invalid transitions have occurred
+ *
+ * An invalid transition means that both signals changed at the same
+ * time, so an edge was missed (only detected in "sig_ab_change" mode)
+ *
+ * @return The number of invalid transitions
+ */
+uint16_t RotaryEncoder::getInvalidCount() {
+	uint8_t start;
+	uint16_t currentCount;
+
+	do {
+		start = sequence;
+		currentCount = invalidCounter;
+	} while ((start & 1) || start != sequence);
+
+	return currentCount;
 }
 
 
@@ -197,10 +414,120 @@ int16_t RotaryEncoder::getCountAndReset() {
  * Reset the rotary step counter
  */
 void RotaryEncoder::reset() {
+	uint8_t oldSREG = SREG;
 	cli();
 	stepCounter = 0;
 	outputCounter = 0;
-	sei();
+	invalidCounter = 0;
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		windowCount = 0;
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
+	SREG = oldSREG;
+}
+
+
+#ifdef ROTARY_ENCODER_TIMESTAMPS
+/**
+ * Change the timings of the velocity estimate
+ *
+ * @param  window  Minimum time in microseconds between estimates; calling
+ *                 getVelocity() more often returns the previous estimate
+ * @param  timeout Time in microseconds without any edges before the
+ *                 velocity is set to zero
+ */
+void RotaryEncoder::setVelocityTimes(unsigned long window, unsigned long timeout) {
+	velocityWindow = window;
+	velocityTimeout = timeout;
+}
+
+
+/**
+ * Estimate the velocity of the encoder
+ *
+ * This should be called regularly, for example at the rate of the
+ * control loop. The count since the previous estimate is divided by
+ * the time between the first and last edge of that window (M/T method).
+ * If there were no edges, the velocity can be at most one step divided
+ * by the time since the last edge, so the estimate decays towards zero.
+ *
+ * @return The velocity in (scaled) counts per second
+ */
+float RotaryEncoder::getVelocity() {
+	const unsigned long now = micros();
+	if (now - windowTime < velocityWindow) return velocity;
+
+	// Copy the count and edge time, repeating if the interrupt changed them
+	uint8_t start;
+	int32_t count;
+	unsigned long lastEdge;
+
+	do {
+		start = sequence;
+		count = stepCounter;
+		lastEdge = edgeTime;
+	} while ((start & 1) || start != sequence);
+
+	// Calculated as unsigned, so that it is still correct if the count wraps around
+	const int32_t steps = (uint32_t) count - (uint32_t) windowCount;
+	const float stepsPerCount = 1 << scaleFactor;
+	windowTime = now;
+
+	// New edges: steps divided by the time between the edges
+	if (steps != 0) {
+		unsigned long period = lastEdge - windowEdgeTime;
+
+		// The previous edge was too long ago to be a useful reference
+		if (period > velocityTimeout) period = velocityTimeout;
+		if (period == 0) period = 1;
+
+		velocity = (steps * 1000000.0) / (period * stepsPerCount);
+		windowCount = count;
+		windowEdgeTime = lastEdge;
+
+	// No edges: the velocity is at most one step since the last edge
+	} else if (velocity != 0) {
+		const unsigned long waiting = now - windowEdgeTime;
+
+		if (waiting >= velocityTimeout) {
+			velocity = 0;
+		} else {
+			const float limit = 1000000.0 / (waiting * stepsPerCount);
+			if (velocity > limit) velocity = limit;
+			else if (velocity < -limit) velocity = -limit;
+		}
+	}
+
+	return velocity;
+}
+#endif /* ROTARY_ENCODER_TIMESTAMPS */
+
+
+/**
+ * Read the state of both signals from the port registers
+ *
+ * @return The state of the signals: (A << 1) | B
+ */
+inline uint8_t RotaryEncoder::readState() {
+	return ((*portA & maskA)? 2 : 0) | ((*portB & maskB)? 1 : 0);
+}
+
+
+/**
+ * Add a step to the counter and update the scaled output
+ *
+ * @param  step The step to be added (-1, 0 or 1)
+ */
+inline void RotaryEncoder::applyStep(int8_t step) {
+	stepCounter += step;
+
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		edgeTime = micros();
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
+
+	// Scale the output with hysteresis
+	if ((stepCounter & ((1 << scaleFactor) - 1)) == 0) {
+		outputCounter = stepCounter >> scaleFactor;
+	}
 }
 
 
@@ -214,54 +541,184 @@ void RotaryEncoder::interruptSignal() {
 	//                 ____      ____
 	//  Signal B  ____|    |____|    |__
 
-	// Truth Table (CHANGE A and B detection code)
-	// Last A |  New B |  New A | Last B | Step Value
-	// 0    0 |      0 |      0 |      0 |   0 (no change)
-	// 1    0 |      1 |      0 |      0 |  -1
-	// 2    0 |      0 |      0 |      1 |  +1
-	// 3    0 |      1 |      0 |      1 |   0 (no change)
-	// 4    0 |      0 |      1 |      0 |  +1
-	// 5    0 |      1 |      1 |      0 |   0 (invalid)
-	// 6    0 |      0 |      1 |      1 |   0 (invalid)
-	// 7    0 |      1 |      1 |      1 |  -1
-	// 8    1 |      0 |      0 |      0 |  -1
-	// 9    1 |      1 |      0 |      0 |   0 (invalid)
-	// 10   1 |      0 |      0 |      1 |   0 (invalid)
-	// 11   1 |      1 |      0 |      1 |  +1
-	// 12   1 |      0 |      1 |      0 |   0 (no change)
-	// 13   1 |      1 |      1 |      0 |  +1
-	// 14   1 |      0 |      1 |      1 |  -1
-	// 15   1 |      1 |      1 |      1 |   0 (no change)
-
-	bool signalA = digitalRead(signalPinA);
-	bool signalB = digitalRead(signalPinB);
+	sequence++;
+
+	const uint8_t state = readState();
+	const bool signalA = state >> 1;
+	const bool signalB = state & 1;
+	const bool lastStateA = lastState >> 1;
 
 	switch (triggerType) {
 		// Signal A RISING detection mode
 		case sig_a_rising:
-			stepCounter += (lastStateA & signalA & !signalB) - (lastStateA & signalA & signalB);
+			applyStep((lastStateA & signalA & !signalB) - (lastStateA & signalA & signalB));
 			break;
 
 		// Signal A CHANGE detection mode
 		case sig_a_change:
-			stepCounter += (signalA ^ signalB) - (lastStateA ^ signalB);
+			applyStep((signalA ^ signalB) - (lastStateA ^ signalB));
 			break;
 
-		// Signal A and Signal B CHANGE detection mode
+		// Signal A and Signal B CHANGE detection mode, using the transition table
 		default:
-		case sig_ab_change:
-			stepCounter += (lastStateB ^ signalA) - (lastStateA ^ signalB);
+		case sig_ab_change: {
+			const int8_t step = encoderTransitions[(lastState << 2) | state];
+			if (step == ENCODER_INVALID) invalidCounter++;
+			else applyStep(step);
 			break;
+		}
 	}
 
-	// Scale the output with hysteresis
-	if ((stepCounter & ((1 << scaleFactor) - 1)) == 0) {
-		outputCounter = stepCounter >> scaleFactor;
+	isrCounter++;
+	lastState = state;
+	sequence++;
+}
+
+
+/**
+ * Sample the encoder signals (polled mode)
+ *
+ * This should be called at a fixed rate from a timer interrupt, at
+ * least (filter samples + 1) times faster than the highest edge rate
+ * of the encoder. While the encoder is not moving, only every Nth
+ * call reads the pins, where N doubles after every few samples
+ * without any changes, up to the maximum set by setPollFilter().
+ */
+void RotaryEncoder::pollSignal() {
+
+	// Skip ticks while the encoder is not moving
+	if (++pollTicks < pollDivider) return;
+	pollTicks = 0;
+
+	const uint8_t state = readState();
+
+	// No change: after a while, halve the sample rate
+	if (state == lastState) {
+		candidateCount = 0;
+
+		if (++pollIdle >= ROTARY_ENCODER_POLL_IDLE) {
+			pollIdle = 0;
+			if (pollDivider < maxPollDivider) {
+				pollDivider = (pollDivider * 2 < maxPollDivider)? pollDivider * 2 : maxPollDivider;
+			}
+		}
+		return;
 	}
 
-	isrCounter++;
-	lastStateA = signalA;
-	lastStateB = signalB;
+	// A change was seen, so return to the full sample rate
+	pollDivider = 1;
+	pollIdle = 0;
+
+	// Glitch filter: the new state needs to be read several times in a row
+	if (state != candidateState) {
+		candidateState = state;
+		candidateCount = 0;
+	}
+	if (++candidateCount < filterSamples) return;
+	candidateCount = 0;
+
+	sequence++;
+
+	const int8_t step = encoderTransitions[(lastState << 2) | state];
+	if (step == ENCODER_INVALID) invalidCounter++;
+	else applyStep(step);
+	lastState = state;
+
+	sequence++;
+}
+
+
+/**
+ * Change the settings of the polled mode
+ *
+ * @param  samples    Number of samples in a row which a new state needs
+ *                    to be read before it is accepted (1 = no filter)
+ * @param  maxDivider Maximum number of ticks between samples while the
+ *                    encoder is not moving (1 = always sample every tick)
+ */
+void RotaryEncoder::setPollFilter(uint8_t samples, uint8_t maxDivider) {
+	uint8_t oldSREG = SREG;
+	cli();
+	filterSamples = (samples > 0)? samples : 1;
+	maxPollDivider = (maxDivider > 0)? maxDivider : 1;
+	pollDivider = 1;
+	pollTicks = 0;
+	SREG = oldSREG;
+}
+
+
+/**
+ * Get the current number of ticks between samples (polled mode)
+ *
+ * @return 1 while the encoder is moving, up to the maximum divider when stopped
+ */
+uint8_t RotaryEncoder::getPollDivider() {
+	return pollDivider;
+}
+
+
+/**
+ * @class FastRotaryEncoder
+ *
+ * Rotary encoder where the trigger type is fixed at compile time, so
+ * the interrupt does not need to check it. Use in the same way as the
+ * RotaryEncoder class, for example:
+ *   FastRotaryEncoder<sig_ab_change> myEncoder(2, 3);
+ *   myEncoder.begin([]{myEncoder.interruptSignal();});
+ *
+ * @tparam Trigger The interrupt trigger type
+ */
+template <enum trigger_t Trigger>
+class FastRotaryEncoder : public RotaryEncoder {
+public:
+	FastRotaryEncoder(uint8_t pinA, uint8_t pinB, bool pullup = false, uint8_t scaling = 3)
+		: RotaryEncoder(pinA, pinB, pullup, Trigger, scaling) {}
+
+	int32_t update();
+	void interruptSignal();
+
+	static_assert(Trigger != sig_polled, "FastRotaryEncoder needs a pin interrupt; use RotaryEncoder for sig_polled");
+};
+
+
+/**
+ * Manually update the encoder state (polling)
+ *
+ * @note   This should only be used if no interrupts are enabled
+ * @return The current encoder step count
+ */
+template <enum trigger_t Trigger>
+int32_t FastRotaryEncoder<Trigger>::update() {
+	interruptSignal();
+	return outputCounter;
+}
+
+
+/**
+ * Encoder interrupt service routine (ISR)
+ */
+template <enum trigger_t Trigger>
+void FastRotaryEncoder<Trigger>::interruptSignal() {
+	sequence++;
+
+	const uint8_t state = readState();
+
+	if (Trigger == sig_ab_change) {
+		const int8_t step = encoderTransitions[(lastState << 2) | state];
+		if (step == ENCODER_INVALID) invalidCounter++;
+		else applyStep(step);
+
+	} else if (Trigger == sig_a_change) {
+		const bool signalB = state & 1;
+		applyStep(((state >> 1) ^ signalB) - ((lastState >> 1) ^ signalB));
+
+	} else {
+		const bool risingA = (lastState >> 1) & (state >> 1);
+		applyStep((risingA & !(state & 1)) - (risingA & (state & 1)));
+	}
+
+	lastState = state;
+	sequence++;
 }
 
 
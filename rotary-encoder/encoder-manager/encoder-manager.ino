@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Encoder Manager Example Sketch
+ *
+ * @file      encoder-manager.ino
+ * @brief     Count the steps of 4 encoders using pin change interrupts
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * @see       <EncoderManager.hpp>
+ *
+ * Four encoders are connected to pins on all three ports of the
+ * Arduino Uno, so all three pin change interrupts are used. The
+ * main loop copies the positions of all encoders at once, and
+ * prints them whenever any of them has changed.
+ *
+ * @note      Copy "EncoderManager.hpp" and "RotaryEncoder.hpp" from
+ *            the parent folder into the folder of this sketch
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "EncoderManager.hpp"
+
+#define NUMBER_OF_ENCODERS 4
+
+const uint8_t pinsA[NUMBER_OF_ENCODERS] = {4, 6, 8, A0};
+const uint8_t pinsB[NUMBER_OF_ENCODERS] = {5, 7, 9, A1};
+
+EncoderManager<NUMBER_OF_ENCODERS> encoders;
+
+int32_t lastPositions[NUMBER_OF_ENCODERS];
+
+
+/**
+ * Pin Change Interrupt Service Routines
+ * Each one is triggered by a different group of pins
+ */
+ISR(PCINT0_vect) {
+	encoders.interruptSignal(0);
+}
+
+ISR(PCINT1_vect) {
+	encoders.interruptSignal(1);
+}
+
+ISR(PCINT2_vect) {
+	encoders.interruptSignal(2);
+}
+
+
+/**
+ * Setup Code
+ */
+void setup() {
+	Serial.begin(115200);
+
+	if (!encoders.begin(pinsA, pinsB, true)) {
+		Serial.println("ERROR: Pin without a pin change interrupt!");
+		while(1) {}
+	}
+
+	encoders.snapshot(lastPositions);
+	Serial.println("--- Encoder Manager Test Code ---");
+}
+
+
+/**
+ * Main Program Loop
+ */
+void loop() {
+	int32_t positions[NUMBER_OF_ENCODERS];
+	encoders.snapshot(positions);
+
+	bool changed = false;
+	for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+		if (positions[i] != lastPositions[i]) changed = true;
+		lastPositions[i] = positions[i];
+	}
+
+	if (changed) {
+		for (uint8_t i = 0; i < NUMBER_OF_ENCODERS; i++) {
+			Serial.print(positions[i]);
+			Serial.print((i < NUMBER_OF_ENCODERS - 1)? ", " : "\n");
+		}
+	}
+}
@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Polled Rotary Encoder Example Sketch
+ *
+ * @file      polled-encoder.ino
+ * @brief     Read a mechanical encoder from a timer interrupt
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * @see       <RotaryEncoder.hpp>
+ *
+ * Instead of triggering an interrupt on every edge, the encoder is
+ * sampled by a 4kHz timer interrupt (Timer2 with a prescale of 32
+ * and a compare value of 124, so exactly 4000Hz). Contact bounce is
+ * filtered out by only accepting a new state once it has been read
+ * on 3 samples in a row (0.75ms). While the encoder is not turned,
+ * the pins are only read every 8th tick (500Hz).
+ *
+ * @note      Copy "RotaryEncoder.hpp" from the parent folder, and
+ *            "setupTimers.h" from the folder "timer-interrupts"
+ *            into the folder of this sketch
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RotaryEncoder.hpp"
+#include "setupTimers.h"
+
+// (Pin A, Pin B, Pullups, Mode, Scaling)
+RotaryEncoder myEncoder(4, 5, true, sig_polled, 2);
+
+int32_t lastCount = 0;
+
+
+/**
+ * Timer 2 Interrupt Service Routine
+ * Sample the encoder signals
+ */
+ISR(TIMER2_COMPA_vect) {
+	myEncoder.pollSignal();
+}
+
+
+/**
+ * Setup Code
+ */
+void setup() {
+	Serial.begin(115200);
+
+	// No pin interrupts are used in the polled mode
+	myEncoder.begin(NULL);
+
+	// (Filter samples, Maximum ticks between samples when idle)
+	myEncoder.setPollFilter(3, 8);
+	setupTimer2(4000);
+
+	Serial.println("--- Polled Rotary Encoder Test Code ---");
+}
+
+
+/**
+ * Main Program Loop
+ */
+void loop() {
+	int32_t count = myEncoder.getCount();
+
+	if (count != lastCount) {
+		lastCount = count;
+		Serial.print("Count: ");
+		Serial.print(count);
+		Serial.print(", invalid: ");
+		Serial.println(myEncoder.getInvalidCount());
+	}
+}
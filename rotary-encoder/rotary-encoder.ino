@@ -27,7 +27,7 @@
 RotaryEncoder myEncoder(2, 3, false, sig_ab_change, 2);
 
 
-int16_t lastCount = 0;
+int32_t lastCount = 0;
 
 /**
  * Setup
@@ -52,4 +52,14 @@ void loop() {
 		lastCount = myEncoder.getCountDebug();
 		Serial.println(lastCount);
 	}
+
+	#ifdef ROTARY_ENCODER_TIMESTAMPS
+		// Print the velocity 10 times per second
+		static unsigned long printTimer = 0;
+		if (millis() - printTimer >= 100) {
+			printTimer = millis();
+			Serial.print("Velocity: ");
+			Serial.println(myEncoder.getVelocity());
+		}
+	#endif /* ROTARY_ENCODER_TIMESTAMPS */
 }
\ No newline at end of file
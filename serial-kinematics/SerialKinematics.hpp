@@ -7,8 +7,8 @@
  * @website   https://wired.chillibasket.com/
  *
  * @copyright Copyright (C) 2021 - MIT License
- * @date      5th July 2021
- * @version   0.1
+ * @date      18th October 2026
+ * @version   0.2
  *
  * @note      This class is still a work in progress!
  * @note      Requires the following library to be installed:
@@ -22,14 +22,149 @@
 // Matrix Library
 #include <BasicLinearAlgebra.h>
 
+/**
+ * Uncomment the next line to use the polynomial sine and cosine functions
+ * from "FastTrig.hpp" for the joint angles, instead of the standard library.
+ * This is faster on microcontrollers without a floating point unit
+ */
+//#define SERIAL_KINEMATICS_FAST_TRIG
+
+// Fast trig functions (always used by the batch calculations)
+#include "FastTrig.hpp"
+
 //using namespace BLA;
 
+/**
+ * Maximum number of joints supported by the inverse kinematics solver
+ * (sets the size of the arrays which are placed on the stack)
+ */
+#ifndef SERIAL_KINEMATICS_MAX_JOINTS
+#define SERIAL_KINEMATICS_MAX_JOINTS 8
+#endif
+
+/**
+ * Number of joint configurations which are processed together by
+ * "forwardKinematicsBatch()". The arrays of each block are placed on
+ * the stack; on a PC, larger blocks make better use of SIMD instructions
+ */
+#ifndef SERIAL_KINEMATICS_BATCH_BLOCK
+#if defined(__AVR__)
+#define SERIAL_KINEMATICS_BATCH_BLOCK 4
+#else
+#define SERIAL_KINEMATICS_BATCH_BLOCK 16
+#endif
+#endif
+
+/**
+ * Tolerance used when checking the structure of the arm for analytic inverse
+ * kinematics, and when detecting gimbal lock in the euler angle conversion
+ */
+#define SERIAL_KINEMATICS_TOLERANCE 1e-4
+
+/**
+ * DH parameter conventions
+ */
+enum dh_convention_t {
+	dh_distal = 0,    // Standard DH, joint rotates about the z-axis of the previous frame
+	dh_proximal = 1   // Modified DH, joint rotates about the z-axis of its own frame
+};
+
 struct DhRow {
 	float a;
 	float alpha;
 	float d;
 	float omega;
-	//bool  distal;
+	uint8_t convention;  // dh_distal (default) or dh_proximal
+
+	// Cached values, calculated by the SerialKinematics class
+	float cosAlpha;
+	float sinAlpha;
+};
+
+
+/**
+ * Joint types
+ */
+enum joint_type_t {
+	joint_revolute = 0,   // The joint value sets the angle "omega"
+	joint_prismatic = 1   // The joint value sets the offset "d"
+};
+
+
+/**
+ * Description of how a joint value is converted to a DH parameter
+ *
+ * The DH parameter is set to "value * scale + offset", which allows the
+ * joint values to be given in other units (such as degrees or encoder steps).
+ * The limits are in the same units as the joint value. If "minValue" and
+ * "maxValue" are equal, the joint has no limits.
+ */
+struct JointDescriptor {
+	uint8_t type;    // joint_revolute or joint_prismatic
+	float offset;    // Added to the scaled value
+	float scale;     // Multiplier of the value (must not be zero)
+	float minValue;  // Lower limit of the joint value
+	float maxValue;  // Upper limit of the joint value
+};
+
+
+/**
+ * Euler angle rotation orders
+ */
+enum euler_order_t {
+	euler_zyx = 0,  // Yaw, pitch and roll: R = Rz * Ry * Rx
+	euler_zyz = 1   // R = Rz * Ry * Rz
+};
+
+
+/**
+ * Rigid body transformation (rotation and translation)
+ *
+ * This stores the top 3 rows of a 4x4 transformation matrix,
+ * since the bottom row is always [0 0 0 1] for rigid motions.
+ */
+struct RigidTransform {
+	float R[3][3];  // Rotation matrix
+	float p[3];     // Translation vector
+};
+
+
+/**
+ * Inverse kinematics result codes
+ */
+enum ik_status_t {
+	ik_success = 0,         // Target reached within the tolerances
+	ik_max_iterations = 1,  // Iteration limit reached, best solution was kept
+	ik_timeout = 2,         // Time limit reached, best solution was kept
+	ik_error = 3,           // Solver can not be used (too many joints, or no frame buffer)
+	ik_unsupported = 4,     // Arm structure is not supported by the analytic solver
+	ik_unreachable = 5      // Target is outside of the workspace
+};
+
+
+/**
+ * Settings of the inverse kinematics solver
+ */
+struct IkOptions {
+	uint16_t maxIterations;      // Maximum number of iterations
+	unsigned long maxTime;       // Maximum duration of the solve in microseconds (0 = no limit)
+	float positionTolerance;     // Allowed position error (same units as the DH parameters)
+	float orientationTolerance;  // Allowed orientation error (radians)
+	float lambda;                // Damping factor, higher values are more stable near singularities
+	bool positionOnly;           // Only solve for the position, ignoring orientation
+	const float *minAngle;       // Lower joint limit for each joint (optional)
+	const float *maxAngle;       // Upper joint limit for each joint (optional)
+
+	IkOptions()
+		: maxIterations(100)
+		, maxTime(0)
+		, positionTolerance(0.01)
+		, orientationTolerance(0.001)
+		, lambda(0.1)
+		, positionOnly(false)
+		, minAngle(NULL)
+		, maxAngle(NULL)
+	{}
 };
 
 
@@ -38,45 +173,130 @@ struct DhRow {
  */
 class SerialKinematics {
 public:
-	SerialKinematics(struct DhRow *dhParams, uint8_t dhLength);
+	SerialKinematics(struct DhRow *dhParams, uint8_t dhLength, struct RigidTransform *frameBuffer = NULL);
 	~SerialKinematics();
 
+	// The frame buffer may be owned by the object, so copies are not allowed
+	SerialKinematics(const SerialKinematics &) = delete;
+	SerialKinematics &operator=(const SerialKinematics &) = delete;
+
 	void proximalDH(BLA::Matrix<4,4> &tMatrix, struct DhRow params);
 	void distalDH(BLA::Matrix<4,4> &tMatrix, struct DhRow params);
 
 	void forwardKinematics(BLA::Matrix<4,4> &tMatrix, uint8_t joints);
 	void forwardKinematics(BLA::Matrix<4,4> &tMatrix);
+
+	void proximalDH(struct RigidTransform &transform, struct DhRow params);
+	void distalDH(struct RigidTransform &transform, struct DhRow params);
+	void multiplyProximalDH(struct RigidTransform &transform, struct DhRow params);
+	void multiplyDistalDH(struct RigidTransform &transform, struct DhRow params);
+	void multiply(struct RigidTransform &result, const struct RigidTransform &lhs, const struct RigidTransform &rhs);
+
+	void forwardKinematics(struct RigidTransform &transform, uint8_t joints);
+	void forwardKinematics(struct RigidTransform &transform);
+	void forwardKinematicsBatch(const float *const *jointValues, unsigned long count, float *x, float *y, float *z, float *const *rotation = NULL) const;
+	bool jacobian(float (*jac)[6], uint8_t joints);
+	bool jacobian(float (*jac)[6]);
+	uint8_t inverseKinematics(const struct RigidTransform &target, const struct IkOptions &options, uint16_t *iterations = NULL);
+	uint8_t analyticInverseKinematics(const struct RigidTransform &target, float (*solutions)[6] = NULL, uint8_t *count = NULL);
+	bool sphericalWrist();
+	void transform2tmatrix(BLA::Matrix<4,4> &tMatrix, const struct RigidTransform &transform);
 	bool setParameter(float value, uint8_t dhRow, uint8_t dhCol);
 	float getParameter(uint8_t dhRow, uint8_t dhCol);
+	void invalidate(uint8_t dhRow = 0);
+	void setJointDescriptors(const struct JointDescriptor *descriptors);
+	bool setJoints(const float *values);
+	void getJoints(float *values);
+
+	/**
+	 * Return error if dynamic frame buffer allocation failed
+	 */
+	bool errors() { return frames == NULL; };
 
 	void tmatrix2coordinates(float (&coordinates)[3], const BLA::Matrix<4,4> &tMatrix);
-	void tmatrix2euler(float (&eulerAngles)[3], const BLA::Matrix<4,4> &tMatrix);
+	void tmatrix2euler(float (&eulerAngles)[3], const BLA::Matrix<4,4> &tMatrix, uint8_t order = euler_zyx);
+	void transform2euler(float (&eulerAngles)[3], const struct RigidTransform &transform, uint8_t order = euler_zyx);
+	void tmatrix2quaternion(float (&quaternion)[4], const BLA::Matrix<4,4> &tMatrix);
+	void transform2quaternion(float (&quaternion)[4], const struct RigidTransform &transform);
+	void tmatrix2axisAngle(float (&axis)[3], float &angle, const BLA::Matrix<4,4> &tMatrix);
+	void transform2axisAngle(float (&axis)[3], float &angle, const struct RigidTransform &transform);
 
 private:
+	void distalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega);
+	void proximalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega);
+	void multiplyDistalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega);
+	void multiplyProximalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega);
+	void sinCos(float angle, float &sinValue, float &cosValue);
+	void updateFrames(uint8_t joints);
+	void appendJoint(struct RigidTransform &transform, const struct DhRow &params, bool first);
+	void poseError(float (&error)[6], const struct RigidTransform &current, const struct RigidTransform &target);
+	bool choleskySolve(float (&A)[6][6], float (&b)[6], uint8_t size);
+	bool prismatic(uint8_t joint);
+	uint8_t jointColumn(uint8_t joint);
+	float jointParameter(uint8_t joint);
+	void parameterLimits(uint8_t joint, float &minValue, float &maxValue);
+	void copyRotation(float (&R)[3][3], const BLA::Matrix<4,4> &tMatrix);
+	void rotation2euler(float (&eulerAngles)[3], const float (&R)[3][3], uint8_t order);
+	void rotation2quaternion(float (&quaternion)[4], const float (&R)[3][3]);
+	void rotation2axisAngle(float (&axis)[3], float &angle, const float (&R)[3][3]);
+
 	struct DhRow *dhParamList;
 	const uint8_t dhListLength;
+	const struct JointDescriptor *jointList;
+
+	// Cached transformations from the base to each joint
+	struct RigidTransform *frames;
+	uint8_t validFrames;
+	bool ownFrames;
 };
 
 
 /**
  * Default constructor
  *
- * @param[in] *dhParams Pointer to list containing the Denavit Hartenberg parameters
- * @param[in] dhLength  The number of items (rows) in the DH parameter list
+ * @param[in] *dhParams    Pointer to list containing the Denavit Hartenberg parameters
+ * @param[in] dhLength     The number of items (rows) in the DH parameter list
+ * @param[in] *frameBuffer Buffer of "dhLength" transformations used to cache the
+ *                         frame of each joint (optional, allocated if left blank)
  */
-SerialKinematics::SerialKinematics(struct DhRow *dhParams, uint8_t dhLength)
+SerialKinematics::SerialKinematics(struct DhRow *dhParams, uint8_t dhLength, struct RigidTransform *frameBuffer)
 	: dhParamList(dhParams)
 	, dhListLength(dhLength)
+	, jointList(NULL)
+	, validFrames(0)
 {
-	
+	// Allocate memory for the cached frames
+	ownFrames = (frameBuffer == NULL);
+	if (ownFrames) frames = new struct RigidTransform[dhLength];
+	else frames = frameBuffer;
+
+	invalidate();
 }
 
 
 /**
  * Default Destructor
+ * Delete the frame buffer if it was allocated by the class
  */
 SerialKinematics::~SerialKinematics() {
-	// Empty
+	if (ownFrames) delete[] frames;
+}
+
+
+/**
+ * Calculate the sine and cosine of a joint angle
+ *
+ * @param[in]  angle    The angle in radians
+ * @param[out] sinValue The sine of the angle
+ * @param[out] cosValue The cosine of the angle
+ */
+inline void SerialKinematics::sinCos(float angle, float &sinValue, float &cosValue) {
+#ifdef SERIAL_KINEMATICS_FAST_TRIG
+	fastSinCos(angle, sinValue, cosValue);
+#else
+	sinValue = sin(angle);
+	cosValue = cos(angle);
+#endif
 }
 
 
@@ -87,10 +307,9 @@ SerialKinematics::~SerialKinematics() {
  * @param[in]  params  DH parameters for current joint (a, alpha, d, omega)
  */
 void SerialKinematics::proximalDH(BLA::Matrix<4,4> &tMatrix, struct DhRow params) {
-	float cosOmega = cos(params.omega);
-	float cosAlpha = cos(params.alpha);
-	float sinOmega = sin(params.omega);
-	float sinAlpha = sin(params.alpha);
+	float cosOmega, sinOmega, cosAlpha, sinAlpha;
+	sinCos(params.omega, sinOmega, cosOmega);
+	sinCos(params.alpha, sinAlpha, cosAlpha);
 
 	// Calculate the proximal transformation matrix
 	tMatrix(0,0) = cosOmega;
@@ -119,10 +338,9 @@ void SerialKinematics::proximalDH(BLA::Matrix<4,4> &tMatrix, struct DhRow params
  * @param[in]  params  DH parameters for current joint (a, alpha, d, omega)
  */
 void SerialKinematics::distalDH(BLA::Matrix<4,4> &tMatrix, struct DhRow params) {
-	float cosOmega = cos(params.omega);
-	float cosAlpha = cos(params.alpha);
-	float sinOmega = sin(params.omega);
-	float sinAlpha = sin(params.alpha);
+	float cosOmega, sinOmega, cosAlpha, sinAlpha;
+	sinCos(params.omega, sinOmega, cosOmega);
+	sinCos(params.alpha, sinAlpha, cosAlpha);
 
 	// Calculate the distal transformation matrix
 	tMatrix(0,0) = cosOmega;
@@ -155,18 +373,20 @@ void SerialKinematics::distalDH(BLA::Matrix<4,4> &tMatrix, struct DhRow params)
  * @param[in]  joint   The joint for which to calculate the transformation matrix
  *                     If left blank it is assumed to be the end effector
  * 
- * @note  This currently only uses the distal convention
- *        You can switch to proximal by replacing "distalDH" with "proximalDH"
+ * @note  The convention (distal or proximal) of each joint is set
+ *        in the "convention" field of its DH row
  */
 void SerialKinematics::forwardKinematics(BLA::Matrix<4,4> &tMatrix, uint8_t joints) {
 
 	// Calculate transformation matrix for the first joint
-	distalDH(tMatrix, dhParamList[0]);
+	if (dhParamList[0].convention == dh_proximal) proximalDH(tMatrix, dhParamList[0]);
+	else distalDH(tMatrix, dhParamList[0]);
 
 	// Calculate and multiply transformations of all subsequent joints
+	BLA::Matrix<4,4> tMatrixTemp;
 	for (int i = 1; i < joints; i++) {
-		BLA::Matrix<4,4> tMatrixTemp;
-		distalDH(tMatrixTemp, dhParamList[i]);
+		if (dhParamList[i].convention == dh_proximal) proximalDH(tMatrixTemp, dhParamList[i]);
+		else distalDH(tMatrixTemp, dhParamList[i]);
 		tMatrix *= tMatrixTemp;
 	}
 }
@@ -176,6 +396,822 @@ void SerialKinematics::forwardKinematics(BLA::Matrix<4,4> &tMatrix) {
 }
 
 
+/**
+ * Denavit Hartenberg rigid transformation using Proximal convention
+ *
+ * @param[out] transform The transformation into which the result should be saved
+ * @param[in]  params    DH parameters for current joint (a, alpha, d, omega)
+ */
+void SerialKinematics::proximalDH(struct RigidTransform &transform, struct DhRow params) {
+	float cosOmega, sinOmega;
+	sinCos(params.omega, sinOmega, cosOmega);
+	sinCos(params.alpha, params.sinAlpha, params.cosAlpha);
+	proximalDH(transform, params, cosOmega, sinOmega);
+}
+
+void SerialKinematics::proximalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega) {
+	float cosAlpha = params.cosAlpha;
+	float sinAlpha = params.sinAlpha;
+
+	transform.R[0][0] = cosOmega;
+	transform.R[0][1] = -sinOmega;
+	transform.R[0][2] = 0;
+	transform.R[1][0] = sinOmega * cosAlpha;
+	transform.R[1][1] = cosOmega * cosAlpha;
+	transform.R[1][2] = -sinAlpha;
+	transform.R[2][0] = sinOmega * sinAlpha;
+	transform.R[2][1] = cosOmega * sinAlpha;
+	transform.R[2][2] = cosAlpha;
+	transform.p[0] = params.a;
+	transform.p[1] = -sinAlpha * params.d;
+	transform.p[2] = cosAlpha * params.d;
+}
+
+
+/**
+ * Denavit Hartenberg rigid transformation using Distal convention
+ *
+ * @param[out] transform The transformation into which the result should be saved
+ * @param[in]  params    DH parameters for current joint (a, alpha, d, omega)
+ */
+void SerialKinematics::distalDH(struct RigidTransform &transform, struct DhRow params) {
+	float cosOmega, sinOmega;
+	sinCos(params.omega, sinOmega, cosOmega);
+	sinCos(params.alpha, params.sinAlpha, params.cosAlpha);
+	distalDH(transform, params, cosOmega, sinOmega);
+}
+
+void SerialKinematics::distalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega) {
+	float cosAlpha = params.cosAlpha;
+	float sinAlpha = params.sinAlpha;
+
+	transform.R[0][0] = cosOmega;
+	transform.R[0][1] = -cosAlpha * sinOmega;
+	transform.R[0][2] = sinAlpha * sinOmega;
+	transform.R[1][0] = sinOmega;
+	transform.R[1][1] = cosAlpha * cosOmega;
+	transform.R[1][2] = -sinAlpha * cosOmega;
+	transform.R[2][0] = 0;
+	transform.R[2][1] = sinAlpha;
+	transform.R[2][2] = cosAlpha;
+	transform.p[0] = params.a * cosOmega;
+	transform.p[1] = params.a * sinOmega;
+	transform.p[2] = params.d;
+}
+
+
+/**
+ * Multiply a transformation by a Proximal DH joint transformation
+ *
+ * This is the same as "transform = transform * proximalDH(params)",
+ * but makes use of the zeros in the DH matrix so that only
+ * 30 multiplications are needed instead of 36 (or 64 for 4x4).
+ *
+ * @param[in,out] transform The transformation to be updated
+ * @param[in]     params    DH parameters for the joint (a, alpha, d, omega)
+ */
+void SerialKinematics::multiplyProximalDH(struct RigidTransform &transform, struct DhRow params) {
+	float cosOmega, sinOmega;
+	sinCos(params.omega, sinOmega, cosOmega);
+	sinCos(params.alpha, params.sinAlpha, params.cosAlpha);
+	multiplyProximalDH(transform, params, cosOmega, sinOmega);
+}
+
+void SerialKinematics::multiplyProximalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega) {
+	float cosAlpha = params.cosAlpha;
+	float sinAlpha = params.sinAlpha;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		float *row = transform.R[i];
+		float v1 = row[1] * cosAlpha + row[2] * sinAlpha;
+		float v2 = row[2] * cosAlpha - row[1] * sinAlpha;
+
+		transform.p[i] += params.a * row[0] + params.d * v2;
+		float r0 = row[0];
+		row[0] = r0 * cosOmega + v1 * sinOmega;
+		row[1] = v1 * cosOmega - r0 * sinOmega;
+		row[2] = v2;
+	}
+}
+
+
+/**
+ * Multiply a transformation by a Distal DH joint transformation
+ *
+ * This is the same as "transform = transform * distalDH(params)",
+ * but makes use of the zero at position (2,0) of the DH matrix so
+ * that only 30 multiplications are needed instead of 36 (or 64 for 4x4).
+ *
+ * @param[in,out] transform The transformation to be updated
+ * @param[in]     params    DH parameters for the joint (a, alpha, d, omega)
+ */
+void SerialKinematics::multiplyDistalDH(struct RigidTransform &transform, struct DhRow params) {
+	float cosOmega, sinOmega;
+	sinCos(params.omega, sinOmega, cosOmega);
+	sinCos(params.alpha, params.sinAlpha, params.cosAlpha);
+	multiplyDistalDH(transform, params, cosOmega, sinOmega);
+}
+
+void SerialKinematics::multiplyDistalDH(struct RigidTransform &transform, const struct DhRow &params, float cosOmega, float sinOmega) {
+	float cosAlpha = params.cosAlpha;
+	float sinAlpha = params.sinAlpha;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		float *row = transform.R[i];
+		float x = row[0] * cosOmega + row[1] * sinOmega;
+		float u = row[1] * cosOmega - row[0] * sinOmega;
+
+		transform.p[i] += params.a * x + params.d * row[2];
+		row[0] = x;
+		row[1] = u * cosAlpha + row[2] * sinAlpha;
+		row[2] = row[2] * cosAlpha - u * sinAlpha;
+	}
+}
+
+
+/**
+ * Multiply two rigid transformations together
+ *
+ * Uses 36 multiplications and 27 additions, compared to the
+ * 64 multiplications and 48 additions of a full 4x4 product.
+ *
+ * @param[out] result The result "lhs * rhs" (must not be the same object as lhs or rhs)
+ * @param[in]  lhs    The transformation on the left side
+ * @param[in]  rhs    The transformation on the right side
+ */
+void SerialKinematics::multiply(struct RigidTransform &result, const struct RigidTransform &lhs, const struct RigidTransform &rhs) {
+	for (uint8_t i = 0; i < 3; i++) {
+		const float *row = lhs.R[i];
+		for (uint8_t j = 0; j < 3; j++) {
+			result.R[i][j] = row[0] * rhs.R[0][j] + row[1] * rhs.R[1][j] + row[2] * rhs.R[2][j];
+		}
+		result.p[i] = row[0] * rhs.p[0] + row[1] * rhs.p[1] + row[2] * rhs.p[2] + lhs.p[i];
+	}
+}
+
+
+/**
+ * Add the transformation of a joint onto the end of a transformation
+ *
+ * @param[in,out] transform The transformation to be updated
+ * @param[in]     params    DH parameters for the joint (with cached alpha values)
+ * @param[in]     first     True if this is the first joint; the transform is then overwritten
+ */
+void SerialKinematics::appendJoint(struct RigidTransform &transform, const struct DhRow &params, bool first) {
+	float cosOmega, sinOmega;
+	sinCos(params.omega, sinOmega, cosOmega);
+
+	if (params.convention == dh_proximal) {
+		if (first) proximalDH(transform, params, cosOmega, sinOmega);
+		else multiplyProximalDH(transform, params, cosOmega, sinOmega);
+	} else {
+		if (first) distalDH(transform, params, cosOmega, sinOmega);
+		else multiplyDistalDH(transform, params, cosOmega, sinOmega);
+	}
+}
+
+
+/**
+ * Update the cached frames of the joints
+ *
+ * The frame of each joint is the product of all joint transformations
+ * up to and including that joint. Only the frames after the first
+ * parameter which was changed need to be recalculated.
+ *
+ * @param[in] joints The number of joint frames which are required
+ */
+void SerialKinematics::updateFrames(uint8_t joints) {
+	for (uint8_t i = validFrames; i < joints; i++) {
+		if (i > 0) frames[i] = frames[i - 1];
+		appendJoint(frames[i], dhParamList[i], i == 0);
+	}
+
+	if (joints > validFrames) validFrames = joints;
+}
+
+
+/**
+ * Calculate forward kinematics using rigid transformations
+ *
+ * This gives the same result as the BLA::Matrix version, but each
+ * joint is multiplied directly into the result without building
+ * a temporary matrix, which is considerably faster. The frame of
+ * each joint is cached, so after "setParameter()" only the joints
+ * from the changed row onwards are recalculated.
+ *
+ * @param[out] transform The transformation into which the result should be saved
+ * @param[in]  joint     The joint for which to calculate the transformation
+ *                       If left blank it is assumed to be the end effector
+ */
+void SerialKinematics::forwardKinematics(struct RigidTransform &transform, uint8_t joints) {
+	if (joints > dhListLength) joints = dhListLength;
+	if (joints == 0) return;
+
+	// Use the cached frames, if available
+	if (frames != NULL) {
+		updateFrames(joints);
+		transform = frames[joints - 1];
+		return;
+	}
+
+	// Otherwise multiply together the transformations of all joints
+	for (uint8_t i = 0; i < joints; i++) {
+		appendJoint(transform, dhParamList[i], i == 0);
+	}
+}
+
+void SerialKinematics::forwardKinematics(struct RigidTransform &transform) {
+	forwardKinematics(transform, dhListLength);
+}
+
+
+/**
+ * Calculate forward kinematics for many joint configurations at once
+ *
+ * The joint values and results are stored as separate arrays (structure of
+ * arrays), so that each step of the calculation can be applied to a block of
+ * configurations in one loop. When compiled on a PC with optimisation (for
+ * example "-O3 -march=native"), these loops are vectorised by the compiler.
+ * The sine and cosine of the joint angles always use "fastSinCos()".
+ * The joint values are the "omega" parameters of each row; the joint
+ * descriptors are not used, so all joints are treated as revolute.
+ *
+ * This function does not modify the class, so the configurations can be
+ * split into chunks which are processed by several threads at the same time.
+ *
+ * @param[in]  jointValues Array of pointers, one for each joint, to the "count" joint angles
+ * @param[in]  count       The number of joint configurations
+ * @param[out] x, y, z     Arrays of size "count" for the end effector position
+ * @param[out] rotation    Array of 9 pointers to arrays of size "count" for the
+ *                         rotation matrix elements in row order (optional)
+ */
+void SerialKinematics::forwardKinematicsBatch(const float *const *jointValues, unsigned long count, float *x, float *y, float *z, float *const *rotation) const {
+	const uint8_t block = SERIAL_KINEMATICS_BATCH_BLOCK;
+
+	for (unsigned long start = 0; start < count; start += block) {
+		const uint8_t n = (count - start < block)? count - start : block;
+		float R[3][3][SERIAL_KINEMATICS_BATCH_BLOCK];
+		float p[3][SERIAL_KINEMATICS_BATCH_BLOCK];
+		float co[SERIAL_KINEMATICS_BATCH_BLOCK];
+		float so[SERIAL_KINEMATICS_BATCH_BLOCK];
+
+		for (uint8_t j = 0; j < dhListLength; j++) {
+			const struct DhRow &row = dhParamList[j];
+			const float *angles = jointValues[j] + start;
+			const float ca = row.cosAlpha;
+			const float sa = row.sinAlpha;
+
+			for (uint8_t k = 0; k < n; k++) fastSinCos(angles[k], so[k], co[k]);
+
+			// Set the transformation of the first joint
+			if (j == 0 && row.convention == dh_proximal) {
+				for (uint8_t k = 0; k < n; k++) {
+					R[0][0][k] = co[k];      R[0][1][k] = -so[k];     R[0][2][k] = 0;
+					R[1][0][k] = so[k] * ca; R[1][1][k] = co[k] * ca; R[1][2][k] = -sa;
+					R[2][0][k] = so[k] * sa; R[2][1][k] = co[k] * sa; R[2][2][k] = ca;
+					p[0][k] = row.a;
+					p[1][k] = -sa * row.d;
+					p[2][k] = ca * row.d;
+				}
+			} else if (j == 0) {
+				for (uint8_t k = 0; k < n; k++) {
+					R[0][0][k] = co[k]; R[0][1][k] = -ca * so[k]; R[0][2][k] = sa * so[k];
+					R[1][0][k] = so[k]; R[1][1][k] = ca * co[k];  R[1][2][k] = -sa * co[k];
+					R[2][0][k] = 0;     R[2][1][k] = sa;          R[2][2][k] = ca;
+					p[0][k] = row.a * co[k];
+					p[1][k] = row.a * so[k];
+					p[2][k] = row.d;
+				}
+
+			// Multiply in the transformations of the subsequent joints
+			} else if (row.convention == dh_proximal) {
+				for (uint8_t i = 0; i < 3; i++) {
+					for (uint8_t k = 0; k < n; k++) {
+						float v1 = R[i][1][k] * ca + R[i][2][k] * sa;
+						float v2 = R[i][2][k] * ca - R[i][1][k] * sa;
+						float r0 = R[i][0][k];
+						p[i][k] += row.a * r0 + row.d * v2;
+						R[i][0][k] = r0 * co[k] + v1 * so[k];
+						R[i][1][k] = v1 * co[k] - r0 * so[k];
+						R[i][2][k] = v2;
+					}
+				}
+			} else {
+				for (uint8_t i = 0; i < 3; i++) {
+					for (uint8_t k = 0; k < n; k++) {
+						float xr = R[i][0][k] * co[k] + R[i][1][k] * so[k];
+						float u = R[i][1][k] * co[k] - R[i][0][k] * so[k];
+						p[i][k] += row.a * xr + row.d * R[i][2][k];
+						R[i][0][k] = xr;
+						R[i][1][k] = u * ca + R[i][2][k] * sa;
+						R[i][2][k] = R[i][2][k] * ca - u * sa;
+					}
+				}
+			}
+		}
+
+		// Copy the results into the output arrays
+		for (uint8_t k = 0; k < n; k++) {
+			x[start + k] = p[0][k];
+			y[start + k] = p[1][k];
+			z[start + k] = p[2][k];
+		}
+
+		if (rotation != NULL) {
+			for (uint8_t e = 0; e < 9; e++) {
+				for (uint8_t k = 0; k < n; k++) rotation[e][start + k] = R[e / 3][e % 3][k];
+			}
+		}
+	}
+}
+
+
+/**
+ * Calculate the geometric Jacobian of the manipulator
+ *
+ * The Jacobian relates the joint velocities to the linear and angular
+ * velocity of the end effector. For each revolute joint, the linear part
+ * is the cross product of the joint axis with the vector from the joint
+ * to the end effector, and the angular part is the joint axis itself.
+ * For prismatic joints, the linear part is the joint axis and there is
+ * no angular part. The velocities are per unit of the DH parameter
+ * (radians or length), not of the scaled joint value.
+ * The joint axes are taken from the cached joint frames, so this costs
+ * little more than one forward kinematics calculation.
+ *
+ * @param[out] jac    Array of size [joints][6] into which the result is saved. Each
+ *                    row contains the velocities [vx, vy, vz, wx, wy, wz] of one joint
+ * @param[in]  joints The number of joints to include, with the end effector at the
+ *                    frame of the last joint. If left blank all joints are used
+ * @return     True if successful, false if the frame buffer could not be allocated
+ */
+bool SerialKinematics::jacobian(float (*jac)[6], uint8_t joints) {
+	if (frames == NULL) return false;
+	if (joints > dhListLength) joints = dhListLength;
+	if (joints == 0) return true;
+
+	updateFrames(joints);
+	const float *end = frames[joints - 1].p;
+
+	for (uint8_t i = 0; i < joints; i++) {
+
+		// Distal joints rotate about the previous frame, proximal about their own
+		float z[3] = {0, 0, 1};
+		float origin[3] = {0, 0, 0};
+		const struct RigidTransform *frame = NULL;
+		if (dhParamList[i].convention == dh_proximal) frame = &frames[i];
+		else if (i > 0) frame = &frames[i - 1];
+
+		if (frame != NULL) {
+			for (uint8_t j = 0; j < 3; j++) {
+				z[j] = frame->R[j][2];
+				origin[j] = frame->p[j];
+			}
+		}
+
+		if (prismatic(i)) {
+			jac[i][0] = z[0];
+			jac[i][1] = z[1];
+			jac[i][2] = z[2];
+			jac[i][3] = 0;
+			jac[i][4] = 0;
+			jac[i][5] = 0;
+			continue;
+		}
+
+		float r[3] = {end[0] - origin[0], end[1] - origin[1], end[2] - origin[2]};
+
+		jac[i][0] = z[1] * r[2] - z[2] * r[1];
+		jac[i][1] = z[2] * r[0] - z[0] * r[2];
+		jac[i][2] = z[0] * r[1] - z[1] * r[0];
+		jac[i][3] = z[0];
+		jac[i][4] = z[1];
+		jac[i][5] = z[2];
+	}
+
+	return true;
+}
+
+bool SerialKinematics::jacobian(float (*jac)[6]) {
+	return jacobian(jac, dhListLength);
+}
+
+
+/**
+ * Calculate the error between the current and target pose
+ *
+ * @param[out] error   Position error [x, y, z] followed by orientation error [x, y, z]
+ * @param[in]  current The current end effector transformation
+ * @param[in]  target  The target end effector transformation
+ */
+void SerialKinematics::poseError(float (&error)[6], const struct RigidTransform &current, const struct RigidTransform &target) {
+	for (uint8_t i = 0; i < 3; i++) {
+		error[i] = target.p[i] - current.p[i];
+		error[i + 3] = 0;
+	}
+
+	// Orientation error is half the sum of the cross products of the axes
+	for (uint8_t k = 0; k < 3; k++) {
+		error[3] += 0.5 * (current.R[1][k] * target.R[2][k] - current.R[2][k] * target.R[1][k]);
+		error[4] += 0.5 * (current.R[2][k] * target.R[0][k] - current.R[0][k] * target.R[2][k]);
+		error[5] += 0.5 * (current.R[0][k] * target.R[1][k] - current.R[1][k] * target.R[0][k]);
+	}
+}
+
+
+/**
+ * Solve the linear system "A x = b" using Cholesky decomposition
+ *
+ * @param[in,out] A    Symmetric positive-definite matrix (overwritten)
+ * @param[in,out] b    Right hand side, replaced by the solution x
+ * @param[in]     size Number of rows/columns of the system which are used
+ * @return        True if successful, false if the matrix is not positive-definite
+ */
+bool SerialKinematics::choleskySolve(float (&A)[6][6], float (&b)[6], uint8_t size) {
+
+	// Decompose A into L * L^T, with L stored in the lower triangle
+	for (uint8_t j = 0; j < size; j++) {
+		float sum = A[j][j];
+		for (uint8_t k = 0; k < j; k++) sum -= A[j][k] * A[j][k];
+		if (sum <= 0) return false;
+		A[j][j] = sqrt(sum);
+
+		for (uint8_t i = j + 1; i < size; i++) {
+			sum = A[i][j];
+			for (uint8_t k = 0; k < j; k++) sum -= A[i][k] * A[j][k];
+			A[i][j] = sum / A[j][j];
+		}
+	}
+
+	// Forward substitution, L * y = b
+	for (uint8_t i = 0; i < size; i++) {
+		for (uint8_t k = 0; k < i; k++) b[i] -= A[i][k] * b[k];
+		b[i] /= A[i][i];
+	}
+
+	// Back substitution, L^T * x = y
+	for (int8_t i = size - 1; i >= 0; i--) {
+		for (uint8_t k = i + 1; k < size; k++) b[i] -= A[k][i] * b[k];
+		b[i] /= A[i][i];
+	}
+
+	return true;
+}
+
+
+/**
+ * Calculate inverse kinematics using damped least squares
+ *
+ * Finds the joint angles which move the end effector to the target pose,
+ * starting from the current joint angles in the DH parameter list. In each
+ * iteration, the joint angles are changed by "J^T (J J^T + lambda^2 I)^-1 e",
+ * where J is the Jacobian and e is the pose error. The damping factor is
+ * adjusted after each step (Levenberg-Marquardt), so that the solver stays
+ * stable near singularities and when the target is out of reach.
+ *
+ * All working memory is on the stack, so the solver can be used with a
+ * limited number of iterations or time inside a regular control loop.
+ * Prismatic joints (see "setJointDescriptors()") are solved by changing
+ * their "d" parameter. If the options do not contain joint limits, the
+ * limits of the joint descriptors are used instead.
+ *
+ * @param[in]  target     The target end effector transformation
+ * @param[in]  options    Solver settings (iterations, time, tolerances, limits)
+ * @param[out] iterations The number of iterations which were needed (optional)
+ * @return     Status code, see "ik_status_t". The joint angles of the DH parameter
+ *             list are set to the result, or to the best attempt if not successful
+ */
+uint8_t SerialKinematics::inverseKinematics(const struct RigidTransform &target, const struct IkOptions &options, uint16_t *iterations) {
+	const uint8_t joints = dhListLength;
+	if (frames == NULL || joints > SERIAL_KINEMATICS_MAX_JOINTS) return ik_error;
+
+	const uint8_t size = options.positionOnly? 3 : 6;
+	float jac[SERIAL_KINEMATICS_MAX_JOINTS][6];
+	float bestJoints[SERIAL_KINEMATICS_MAX_JOINTS];
+	float bestError[6];
+	float bestCost = -1;
+	float lambda = options.lambda;
+	uint8_t status = ik_max_iterations;
+	unsigned long startTime = micros();
+	uint16_t count = 0;
+
+	while (true) {
+		struct RigidTransform current;
+		float error[6];
+		forwardKinematics(current);
+		poseError(error, current, target);
+
+		float posError = error[0] * error[0] + error[1] * error[1] + error[2] * error[2];
+		float rotError = error[3] * error[3] + error[4] * error[4] + error[5] * error[5];
+		float cost = options.positionOnly? posError : posError + rotError;
+
+		// Stop if the target has been reached
+		if (posError <= options.positionTolerance * options.positionTolerance
+			&& (options.positionOnly || rotError <= options.orientationTolerance * options.orientationTolerance)) {
+			status = ik_success;
+			break;
+		}
+
+		// If the error decreased, keep the new joint angles and reduce the damping.
+		// Otherwise go back to the best joint angles and increase the damping
+		if (bestCost < 0 || cost < bestCost) {
+			bestCost = cost;
+			for (uint8_t i = 0; i < 6; i++) bestError[i] = error[i];
+			for (uint8_t i = 0; i < joints; i++) bestJoints[i] = jointParameter(i);
+			lambda *= 0.5;
+			if (lambda < options.lambda * 0.01) lambda = options.lambda * 0.01;
+		} else {
+			for (uint8_t i = 0; i < joints; i++) setParameter(bestJoints[i], i, jointColumn(i));
+			lambda *= 4;
+		}
+
+		// Check the iteration and time budgets
+		if (count >= options.maxIterations) break;
+		if (options.maxTime > 0 && micros() - startTime >= options.maxTime) {
+			status = ik_timeout;
+			break;
+		}
+		count++;
+
+		// A = J J^T + lambda^2 I
+		jacobian(jac, joints);
+		float A[6][6];
+		float y[6];
+		for (uint8_t r = 0; r < size; r++) {
+			for (uint8_t c = 0; c <= r; c++) {
+				float sum = 0;
+				for (uint8_t i = 0; i < joints; i++) sum += jac[i][r] * jac[i][c];
+				A[r][c] = sum;
+			}
+			A[r][r] += lambda * lambda;
+			y[r] = bestError[r];
+		}
+
+		// Solve A y = e, then apply the joint changes J^T y
+		if (!choleskySolve(A, y, size)) {
+			lambda *= 4;
+			continue;
+		}
+
+		for (uint8_t i = 0; i < joints; i++) {
+			float value = jointParameter(i);
+			for (uint8_t r = 0; r < size; r++) value += jac[i][r] * y[r];
+
+			if (options.minAngle != NULL || options.maxAngle != NULL) {
+				if (options.minAngle != NULL && value < options.minAngle[i]) value = options.minAngle[i];
+				if (options.maxAngle != NULL && value > options.maxAngle[i]) value = options.maxAngle[i];
+			} else if (jointList != NULL && jointList[i].minValue != jointList[i].maxValue) {
+				float minValue, maxValue;
+				parameterLimits(i, minValue, maxValue);
+				if (value < minValue) value = minValue;
+				if (value > maxValue) value = maxValue;
+			}
+			setParameter(value, i, jointColumn(i));
+		}
+	}
+
+	// If not successful, return the best joint angles which were found
+	if (status != ik_success) {
+		for (uint8_t i = 0; i < joints; i++) setParameter(bestJoints[i], i, jointColumn(i));
+	}
+
+	if (iterations != NULL) *iterations = count;
+	return status;
+}
+
+
+/**
+ * Check if the arm has a structure supported by the analytic inverse kinematics
+ *
+ * The arm needs 6 revolute joints using the distal convention, with an anthropomorphic
+ * arm (joint 1 perpendicular to joint 2, joints 2 and 3 parallel) and a
+ * spherical wrist (the axes of the last three joints intersect at one point).
+ * The DH parameters should therefore be of the form:
+ *
+ *  Row     a    alpha     d
+ *   0     a1    ±PI/2    d1
+ *   1     a2      0      d2
+ *   2     a3    ±PI/2    d3
+ *   3      0    ±PI/2    d4
+ *   4      0    ±PI/2     0
+ *   5     a6    alpha6   d6   (tool offset)
+ *
+ * @return True if the structure is supported, false otherwise
+ */
+bool SerialKinematics::sphericalWrist() {
+	if (dhListLength != 6) return false;
+
+	const struct DhRow *row = dhParamList;
+	for (uint8_t i = 0; i < 6; i++) {
+		if (row[i].convention != dh_distal || prismatic(i)) return false;
+	}
+
+	// Perpendicular and parallel joint axes
+	if (abs(row[0].cosAlpha) > SERIAL_KINEMATICS_TOLERANCE) return false;
+	if (abs(row[1].sinAlpha) > SERIAL_KINEMATICS_TOLERANCE || row[1].cosAlpha < 0) return false;
+	if (abs(row[2].cosAlpha) > SERIAL_KINEMATICS_TOLERANCE) return false;
+	if (abs(row[3].cosAlpha) > SERIAL_KINEMATICS_TOLERANCE) return false;
+	if (abs(row[4].cosAlpha) > SERIAL_KINEMATICS_TOLERANCE) return false;
+
+	// Wrist axes intersect at one point
+	if (abs(row[3].a) > SERIAL_KINEMATICS_TOLERANCE) return false;
+	if (abs(row[4].a) > SERIAL_KINEMATICS_TOLERANCE) return false;
+	if (abs(row[4].d) > SERIAL_KINEMATICS_TOLERANCE) return false;
+
+	// Both links of the arm need a length
+	if (abs(row[1].a) < SERIAL_KINEMATICS_TOLERANCE) return false;
+	if (abs(row[2].a) + abs(row[3].d) < SERIAL_KINEMATICS_TOLERANCE) return false;
+
+	return true;
+}
+
+
+/**
+ * Calculate inverse kinematics analytically, for arms with a spherical wrist
+ *
+ * The position of the wrist centre only depends on the first three joints,
+ * so these are found first using the geometry of the arm (2 shoulder and 2
+ * elbow solutions). The last three joints then provide the remaining
+ * rotation to the target orientation (2 wrist solutions). Of all valid
+ * solutions, the one closest to the current joint angles is used.
+ *
+ * This is much faster than the iterative solver, but only works with
+ * the arm structure described in "sphericalWrist()".
+ *
+ * @param[in]  target    The target end effector transformation
+ * @param[out] solutions Array of size [8][6] into which all solutions are saved (optional)
+ * @param[out] count     The number of solutions which were found (optional)
+ * @return     Status code, see "ik_status_t". If successful, the joint angles
+ *             of the DH parameter list are set to the closest solution
+ */
+uint8_t SerialKinematics::analyticInverseKinematics(const struct RigidTransform &target, float (*solutions)[6], uint8_t *count) {
+	if (count != NULL) *count = 0;
+	if (!sphericalWrist()) return ik_unsupported;
+
+	const struct DhRow *row = dhParamList;
+	float current[6];
+	float best[6];
+	float bestDistance = -1;
+	uint8_t found = 0;
+
+	for (uint8_t i = 0; i < 6; i++) current[i] = row[i].omega;
+
+	// Wrist centre, found by removing the tool offset from the target
+	float wrist[3];
+	for (uint8_t i = 0; i < 3; i++) {
+		wrist[i] = target.p[i] - row[5].a * target.R[i][0]
+			- row[5].d * (row[5].sinAlpha * target.R[i][1] + row[5].cosAlpha * target.R[i][2]);
+	}
+
+	// Joint 1: the wrist centre has to lie in the plane of the arm, which is
+	// offset from the base axis by the "d" parameters of joints 2 and 3
+	float offset = (row[1].d + row[2].d) * row[0].sinAlpha;
+	float radius = sqrt(wrist[0] * wrist[0] + wrist[1] * wrist[1]);
+	if (radius < abs(offset) - SERIAL_KINEMATICS_TOLERANCE) return ik_unreachable;
+
+	float shoulder[2];
+	if (radius < SERIAL_KINEMATICS_TOLERANCE) {
+		// Wrist centre is on the base axis, so any angle works
+		shoulder[0] = shoulder[1] = current[0];
+	} else {
+		float heading = atan2(wrist[1], wrist[0]);
+		float ratio = offset / radius;
+		if (ratio > 1) ratio = 1;
+		else if (ratio < -1) ratio = -1;
+		shoulder[0] = heading + asin(ratio);
+		shoulder[1] = heading + PI - asin(ratio);
+	}
+
+	// Joints 2 and 3 form a planar 2-link arm; the second link points from
+	// joint 3 to the wrist centre, with an angle offset relative to joint 3
+	float link1 = row[1].a;
+	float link2x = row[2].a;
+	float link2y = -row[2].sinAlpha * row[3].d;
+	float link2 = sqrt(link2x * link2x + link2y * link2y);
+	float link2Angle = atan2(link2y, link2x);
+
+	for (uint8_t s = 0; s < 2; s++) {
+		float theta1 = shoulder[s];
+		float c1 = cos(theta1);
+		float s1 = sin(theta1);
+
+		// Wrist centre in the plane of the arm (frame of joint 1)
+		float x = wrist[0] * c1 + wrist[1] * s1 - row[0].a;
+		float y = row[0].sinAlpha * (wrist[2] - row[0].d);
+
+		float cosElbow = (x * x + y * y - link1 * link1 - link2 * link2) / (2 * link1 * link2);
+		if (abs(cosElbow) > 1 + SERIAL_KINEMATICS_TOLERANCE) continue;
+		if (cosElbow > 1) cosElbow = 1;
+		else if (cosElbow < -1) cosElbow = -1;
+
+		for (uint8_t e = 0; e < 2; e++) {
+			float elbow = (e == 0)? acos(cosElbow) : -acos(cosElbow);
+			float theta3 = elbow - link2Angle;
+			float theta2 = atan2(y, x) - atan2(link2 * sin(elbow), link1 + link2 * cos(elbow));
+
+			// Rotation of the first three joints
+			struct DhRow joint;
+			struct RigidTransform arm;
+			joint = row[0]; joint.omega = theta1; appendJoint(arm, joint, true);
+			joint = row[1]; joint.omega = theta2; appendJoint(arm, joint, false);
+			joint = row[2]; joint.omega = theta3; appendJoint(arm, joint, false);
+
+			// Rotation needed from the wrist: M = R03^T * R * Rx(alpha6)^T
+			float wristRot[3][3];
+			for (uint8_t i = 0; i < 3; i++) {
+				for (uint8_t j = 0; j < 3; j++) wristRot[i][j] = 0;
+
+				for (uint8_t k = 0; k < 3; k++) {
+					float y = target.R[k][1];
+					float z = target.R[k][2];
+					wristRot[i][0] += arm.R[k][i] * target.R[k][0];
+					wristRot[i][1] += arm.R[k][i] * (row[5].cosAlpha * y - row[5].sinAlpha * z);
+					wristRot[i][2] += arm.R[k][i] * (row[5].sinAlpha * y + row[5].cosAlpha * z);
+				}
+			}
+
+			// Joint 5, with two solutions (wrist flipped or not)
+			float s4 = row[3].sinAlpha;
+			float s5 = row[4].sinAlpha;
+			float cos5 = -s4 * s5 * wristRot[2][2];
+			if (cos5 > 1) cos5 = 1;
+			else if (cos5 < -1) cos5 = -1;
+			float sin5 = sqrt(1 - cos5 * cos5);
+
+			for (uint8_t w = 0; w < 2; w++) {
+				float result[6] = {theta1, theta2, theta3, 0, 0, 0};
+				float sign = (w == 0)? 1 : -1;
+
+				if (sin5 > SERIAL_KINEMATICS_TOLERANCE) {
+					result[3] = atan2(sign * s5 * wristRot[1][2], sign * s5 * wristRot[0][2]);
+					result[4] = atan2(sign * sin5, cos5);
+					result[5] = atan2(-sign * s4 * wristRot[2][1], sign * s4 * wristRot[2][0]);
+				} else {
+					// Wrist singularity: joints 4 and 6 are aligned, so keep joint 4
+					// where it is and let joint 6 provide all of the rotation
+					if (w == 1) continue;
+					result[3] = current[3];
+					result[4] = atan2(0, cos5);
+					joint = row[3]; joint.omega = result[3]; appendJoint(arm, joint, true);
+					joint = row[4]; joint.omega = result[4]; appendJoint(arm, joint, false);
+					float c6 = 0, s6 = 0;
+					for (uint8_t k = 0; k < 3; k++) {
+						c6 += arm.R[k][0] * wristRot[k][0];
+						s6 += arm.R[k][1] * wristRot[k][0];
+					}
+					result[5] = atan2(s6, c6);
+				}
+
+				// Move each angle to within PI of the current angle, and find distance
+				float distance = 0;
+				for (uint8_t i = 0; i < 6; i++) {
+					float change = result[i] - current[i];
+					change = atan2(sin(change), cos(change));
+					result[i] = current[i] + change;
+					distance += change * change;
+				}
+
+				if (solutions != NULL) {
+					for (uint8_t i = 0; i < 6; i++) solutions[found][i] = result[i];
+				}
+				found++;
+
+				if (bestDistance < 0 || distance < bestDistance) {
+					bestDistance = distance;
+					for (uint8_t i = 0; i < 6; i++) best[i] = result[i];
+				}
+			}
+		}
+	}
+
+	if (count != NULL) *count = found;
+	if (found == 0) return ik_unreachable;
+
+	for (uint8_t i = 0; i < 6; i++) setParameter(best[i], i, 3);
+	return ik_success;
+}
+
+
+/**
+ * Convert a rigid transformation into a 4x4 transformation matrix
+ *
+ * @param[out] tMatrix   The 4x4 transformation matrix
+ * @param[in]  transform The rigid transformation
+ */
+void SerialKinematics::transform2tmatrix(BLA::Matrix<4,4> &tMatrix, const struct RigidTransform &transform) {
+	for (uint8_t i = 0; i < 3; i++) {
+		tMatrix(i,0) = transform.R[i][0];
+		tMatrix(i,1) = transform.R[i][1];
+		tMatrix(i,2) = transform.R[i][2];
+		tMatrix(i,3) = transform.p[i];
+	}
+	tMatrix(3,0) = 0;
+	tMatrix(3,1) = 0;
+	tMatrix(3,2) = 0;
+	tMatrix(3,3) = 1;
+}
+
+
 /**
  * Get XYZ coordinates from a transformation matrix
  *
@@ -193,86 +1229,218 @@ void SerialKinematics::tmatrix2coordinates(float (&coordinates)[3], const BLA::M
 /**
  * Get euler angles from a transformation matrix
  *
- * @param(out) eulerAngles The euler angles
- * @param(in)  tMatrix     The 4x4 transformation matrix
- * 
- * @note  This function still needs to be properly tested
+ * @param[out] eulerAngles The euler angles [z, y, x] for ZYX (yaw, pitch, roll) or [z, y, z] for ZYZ
+ * @param[in]  tMatrix     The 4x4 transformation matrix
+ * @param[in]  order       The rotation order, euler_zyx (default) or euler_zyz
  */
-void SerialKinematics::tmatrix2euler(float (&eulerAngles)[3], const BLA::Matrix<4,4> &tMatrix) {
+void SerialKinematics::tmatrix2euler(float (&eulerAngles)[3], const BLA::Matrix<4,4> &tMatrix, uint8_t order) {
+	float R[3][3];
+	copyRotation(R, tMatrix);
+	rotation2euler(eulerAngles, R, order);
+}
 
-	// Calculate Euler angles using ZYX convention
-	if (tMatrix(2,0) != 1 && tMatrix(2,0) != -1) {
-		eulerAngles[1] = -asin(tMatrix(2,0));
-		eulerAngles[2] = atan2(tMatrix(2,1) / cos(eulerAngles[1]), tMatrix(2,2) / cos(eulerAngles[1]));
-		eulerAngles[0] = atan2(tMatrix(1,0) / cos(eulerAngles[1]), tMatrix(0,0) / cos(eulerAngles[1]));
-	} else {
-		eulerAngles[2] = 0;
-		if (tMatrix(2,0) == -1) {
-			eulerAngles[1] = PI / 2.0;
-			eulerAngles[0] = atan2(tMatrix(0,1), tMatrix(0,2));
-		} else {
-			eulerAngles[1] = -PI / 2.0;
-			eulerAngles[0] = atan2(-tMatrix(0,1), -tMatrix(0,2));
-		}
+
+/**
+ * Get euler angles from a rigid transformation
+ *
+ * @param[out] eulerAngles The euler angles [z, y, x] for ZYX (yaw, pitch, roll) or [z, y, z] for ZYZ
+ * @param[in]  transform   The rigid transformation
+ * @param[in]  order       The rotation order, euler_zyx (default) or euler_zyz
+ */
+void SerialKinematics::transform2euler(float (&eulerAngles)[3], const struct RigidTransform &transform, uint8_t order) {
+	rotation2euler(eulerAngles, transform.R, order);
+}
+
+
+/**
+ * Get the orientation quaternion from a transformation matrix
+ *
+ * @param[out] quaternion The unit quaternion [w, x, y, z]
+ * @param[in]  tMatrix    The 4x4 transformation matrix
+ */
+void SerialKinematics::tmatrix2quaternion(float (&quaternion)[4], const BLA::Matrix<4,4> &tMatrix) {
+	float R[3][3];
+	copyRotation(R, tMatrix);
+	rotation2quaternion(quaternion, R);
+}
+
+
+/**
+ * Get the orientation quaternion from a rigid transformation
+ *
+ * @param[out] quaternion The unit quaternion [w, x, y, z]
+ * @param[in]  transform  The rigid transformation
+ */
+void SerialKinematics::transform2quaternion(float (&quaternion)[4], const struct RigidTransform &transform) {
+	rotation2quaternion(quaternion, transform.R);
+}
+
+
+/**
+ * Get the orientation as a rotation about an axis, from a transformation matrix
+ *
+ * @param[out] axis    The unit vector of the rotation axis
+ * @param[out] angle   The rotation angle in radians, in the range [0, PI]
+ * @param[in]  tMatrix The 4x4 transformation matrix
+ */
+void SerialKinematics::tmatrix2axisAngle(float (&axis)[3], float &angle, const BLA::Matrix<4,4> &tMatrix) {
+	float R[3][3];
+	copyRotation(R, tMatrix);
+	rotation2axisAngle(axis, angle, R);
+}
+
+
+/**
+ * Get the orientation as a rotation about an axis, from a rigid transformation
+ *
+ * @param[out] axis      The unit vector of the rotation axis
+ * @param[out] angle     The rotation angle in radians, in the range [0, PI]
+ * @param[in]  transform The rigid transformation
+ */
+void SerialKinematics::transform2axisAngle(float (&axis)[3], float &angle, const struct RigidTransform &transform) {
+	rotation2axisAngle(axis, angle, transform.R);
+}
+
+
+/**
+ * Copy the rotation part of a transformation matrix into a 3x3 array
+ *
+ * @param[out] R       The rotation matrix
+ * @param[in]  tMatrix The 4x4 transformation matrix
+ */
+void SerialKinematics::copyRotation(float (&R)[3][3], const BLA::Matrix<4,4> &tMatrix) {
+	for (uint8_t i = 0; i < 3; i++) {
+		R[i][0] = tMatrix(i,0);
+		R[i][1] = tMatrix(i,1);
+		R[i][2] = tMatrix(i,2);
 	}
+}
 
-	// Calculate Euler angles using ZYX convention
-	// If r31 is not 1, then sin(r31) only has one value:
-	/*
-	if (tMatrix(2,0) < 1) {
-		// case 1: if r31 ~= ±1
-		if (tMatrix(2,0) > -1) {
-			// Solution with positive sign. It limits the range of the values
-			// of theta_y to (-pi/2, pi/2):
-			eulerAngles[0] = atan2(tMatrix(1,0), tMatrix(0,0));
-			eulerAngles[1] = asin(-tMatrix(2,0));
-			eulerAngles[2] = atan2(tMatrix(2,1), tMatrix(2,2));
-		// case 2: if r31 = -1
+
+/**
+ * Calculate the euler angles of a rotation matrix
+ *
+ * Near gimbal lock (pitch of ±90° for ZYX, or middle angle of 0° or 180°
+ * for ZYZ) the first and last angles rotate about the same axis, so only
+ * their sum or difference is defined. In this case the last angle is set
+ * to zero and the whole rotation is given by the first angle.
+ *
+ * @param[out] eulerAngles The euler angles
+ * @param[in]  R           The rotation matrix
+ * @param[in]  order       The rotation order, euler_zyx or euler_zyz
+ */
+void SerialKinematics::rotation2euler(float (&eulerAngles)[3], const float (&R)[3][3], uint8_t order) {
+
+	if (order == euler_zyz) {
+		// R = Rz(a) * Ry(b) * Rz(c), where sin(b) = length of [R02, R12]
+		float sinB = sqrt(R[0][2] * R[0][2] + R[1][2] * R[1][2]);
+
+		if (sinB > SERIAL_KINEMATICS_TOLERANCE) {
+			eulerAngles[0] = atan2(R[1][2], R[0][2]);
+			eulerAngles[1] = atan2(sinB, R[2][2]);
+			eulerAngles[2] = atan2(R[2][1], -R[2][0]);
 		} else {
-			// theta_x and theta_z are linked --> Gimbal lock:
-			// There are infinity number of solutions for theta_x - theta_z = atan2(-r23, r22).
-			// To find a solution, set theta_x = 0 by convention.
-			eulerAngles[0] = -atan2(-tMatrix(1,2), tMatrix(1,1));
-			eulerAngles[1] = PI / 2.0;
+			// Gimbal lock: set the last angle to zero
+			eulerAngles[0] = atan2(-R[0][1], R[1][1]);
+			eulerAngles[1] = (R[2][2] > 0)? 0 : PI;
 			eulerAngles[2] = 0;
 		}
-	// case 3: if r31 = 1, then sin(r31) has two possible values
+
 	} else {
-		// Gimbal lock: There is not a unique solution for
-		// theta_x + theta_z = atan2(-r23, r22), by convention, set theta_x = 0.
-		eulerAngles[0] = atan2(-tMatrix(1,2), tMatrix(1,1));
-		eulerAngles[1] = PI / 2.0;
-		eulerAngles[2] = 0;
-	}*/
-
-	/*
-    // Calculate Euler angles using ZYZ convention
-	if (tMatrix(2,2) < 1) {
-
-		// Solution with positive sign, i.e. theta_y is in the range (0, pi):
-		if (tMatrix(2,2) > -1) {
-			eulerAngles[0] = atan2(tMatrix(1,2), tMatrix(0,2));
-			eulerAngles[1] = acos(tMatrix(2,2));
-			eulerAngles[2] = atan2(tMatrix(2,1), -tMatrix(2,0));
-
-		// if r33 = -1:
+		// R = Rz(a) * Ry(b) * Rx(c), where cos(b) = length of [R00, R10]
+		float cosB = sqrt(R[0][0] * R[0][0] + R[1][0] * R[1][0]);
+
+		if (cosB > SERIAL_KINEMATICS_TOLERANCE) {
+			eulerAngles[0] = atan2(R[1][0], R[0][0]);
+			eulerAngles[1] = atan2(-R[2][0], cosB);
+			eulerAngles[2] = atan2(R[2][1], R[2][2]);
 		} else {
-			// Gimbal lock: infinity number of solutions for
-			// theta_z2 - theta_z1 = atan2(r21, r22), --> set theta_z2 = 0.
-			eulerAngles[0] = -atan2(tMatrix(1,0), tMatrix(1,1));
-			eulerAngles[1] = PI;
+			// Gimbal lock: set the roll angle to zero
+			eulerAngles[0] = atan2(-R[0][1], R[1][1]);
+			eulerAngles[1] = (R[2][0] < 0)? PI / 2.0 : -PI / 2.0;
 			eulerAngles[2] = 0;
 		}
+	}
+}
+
+
+/**
+ * Calculate the quaternion of a rotation matrix (Shepperd's method)
+ *
+ * The square root is taken of the largest of the four possible
+ * diagonal combinations, which avoids dividing by a small number when
+ * the rotation angle is close to 180°. The result is returned with a
+ * positive (or zero) w component.
+ *
+ * @param[out] quaternion The unit quaternion [w, x, y, z]
+ * @param[in]  R          The rotation matrix
+ */
+void SerialKinematics::rotation2quaternion(float (&quaternion)[4], const float (&R)[3][3]) {
+	float trace = R[0][0] + R[1][1] + R[2][2];
+	float w, x, y, z;
 
-	// if r33 = 1:
+	if (trace >= R[0][0] && trace >= R[1][1] && trace >= R[2][2]) {
+		float s = 2 * sqrt(1 + trace);
+		w = 0.25 * s;
+		x = (R[2][1] - R[1][2]) / s;
+		y = (R[0][2] - R[2][0]) / s;
+		z = (R[1][0] - R[0][1]) / s;
+	} else if (R[0][0] >= R[1][1] && R[0][0] >= R[2][2]) {
+		float s = 2 * sqrt(1 + R[0][0] - R[1][1] - R[2][2]);
+		w = (R[2][1] - R[1][2]) / s;
+		x = 0.25 * s;
+		y = (R[0][1] + R[1][0]) / s;
+		z = (R[0][2] + R[2][0]) / s;
+	} else if (R[1][1] >= R[2][2]) {
+		float s = 2 * sqrt(1 + R[1][1] - R[0][0] - R[2][2]);
+		w = (R[0][2] - R[2][0]) / s;
+		x = (R[0][1] + R[1][0]) / s;
+		y = 0.25 * s;
+		z = (R[1][2] + R[2][1]) / s;
 	} else {
-		// Gimbal lock: infinity number of solutions for
-		// theta_z2 + theta_z1 = atan2(r21, r22), --> set theta_z2 = 0.
-		eulerAngles[0] = atan2(tMatrix(1,0), tMatrix(1,1));
-		eulerAngles[1] = 0;
-		eulerAngles[2] = 0;
+		float s = 2 * sqrt(1 + R[2][2] - R[0][0] - R[1][1]);
+		w = (R[1][0] - R[0][1]) / s;
+		x = (R[0][2] + R[2][0]) / s;
+		y = (R[1][2] + R[2][1]) / s;
+		z = 0.25 * s;
+	}
+
+	// q and -q describe the same rotation; always return the one with w >= 0
+	float sign = (w < 0)? -1 : 1;
+	quaternion[0] = sign * w;
+	quaternion[1] = sign * x;
+	quaternion[2] = sign * y;
+	quaternion[3] = sign * z;
+}
+
+
+/**
+ * Calculate the axis and angle of a rotation matrix
+ *
+ * This is calculated from the quaternion, so that it stays accurate
+ * for angles close to 0° and 180°. If there is no rotation, the
+ * z-axis is returned with an angle of zero.
+ *
+ * @param[out] axis  The unit vector of the rotation axis
+ * @param[out] angle The rotation angle in radians, in the range [0, PI]
+ * @param[in]  R     The rotation matrix
+ */
+void SerialKinematics::rotation2axisAngle(float (&axis)[3], float &angle, const float (&R)[3][3]) {
+	float q[4];
+	rotation2quaternion(q, R);
+
+	float length = sqrt(q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+	angle = 2 * atan2(length, q[0]);
+
+	if (length > 1e-12) {
+		axis[0] = q[1] / length;
+		axis[1] = q[2] / length;
+		axis[2] = q[3] / length;
+	} else {
+		axis[0] = 0;
+		axis[1] = 0;
+		axis[2] = 1;
 	}
-	*/
 }
 
 
@@ -296,16 +1464,163 @@ bool SerialKinematics::setParameter(float value, uint8_t dhRow, uint8_t dhCol) {
 
 	switch(dhCol) {
 		case 0: dhParamList[dhRow].a = value;     break;
-		case 1: dhParamList[dhRow].alpha = value; break;
 		case 2: dhParamList[dhRow].d = value;     break;
 		case 3: dhParamList[dhRow].omega = value; break;
+		case 1:
+			dhParamList[dhRow].alpha = value;
+			dhParamList[dhRow].cosAlpha = cos(value);
+			dhParamList[dhRow].sinAlpha = sin(value);
+			break;
 		default: return false;
 	}
 
+	// Frames from this joint onwards need to be recalculated
+	if (dhRow < validFrames) validFrames = dhRow;
+
 	return true;
 }
 
 
+/**
+ * Mark the cached values as out of date
+ *
+ * This is done automatically by "setParameter()", but needs to be called
+ * if the DH parameter list is modified directly.
+ *
+ * @param  dhRow The first DH row which was changed (default = 0, all rows)
+ */
+void SerialKinematics::invalidate(uint8_t dhRow) {
+	for (uint8_t i = dhRow; i < dhListLength; i++) {
+		dhParamList[i].cosAlpha = cos(dhParamList[i].alpha);
+		dhParamList[i].sinAlpha = sin(dhParamList[i].alpha);
+	}
+
+	if (dhRow < validFrames) validFrames = dhRow;
+}
+
+
+/**
+ * Set the joint descriptors, which define the type, scale and limits of each joint
+ *
+ * @param[in] descriptors Pointer to a list with one descriptor for each DH row,
+ *                        or NULL to use revolute joints without scaling or limits
+ */
+void SerialKinematics::setJointDescriptors(const struct JointDescriptor *descriptors) {
+	jointList = descriptors;
+}
+
+
+/**
+ * Set the values of all joints at the same time
+ *
+ * Each value is limited, scaled and saved into the DH parameter of the
+ * joint ("omega" for revolute or "d" for prismatic joints). The cached
+ * frames are only invalidated from the first joint which changed, so
+ * this is faster than calling "setParameter()" for every joint.
+ *
+ * @param[in] values Array with one value for each joint
+ * @return    True if all values were within the joint limits, false if any were limited
+ */
+bool SerialKinematics::setJoints(const float *values) {
+	bool withinLimits = true;
+	uint8_t firstChanged = dhListLength;
+
+	for (uint8_t i = 0; i < dhListLength; i++) {
+		float value = values[i];
+		float *parameter = &dhParamList[i].omega;
+
+		if (jointList != NULL) {
+			const struct JointDescriptor &joint = jointList[i];
+			if (joint.minValue != joint.maxValue) {
+				if (value < joint.minValue) { value = joint.minValue; withinLimits = false; }
+				if (value > joint.maxValue) { value = joint.maxValue; withinLimits = false; }
+			}
+			value = value * joint.scale + joint.offset;
+			if (joint.type == joint_prismatic) parameter = &dhParamList[i].d;
+		}
+
+		if (*parameter != value) {
+			*parameter = value;
+			if (firstChanged == dhListLength) firstChanged = i;
+		}
+	}
+
+	if (firstChanged < validFrames) validFrames = firstChanged;
+
+	return withinLimits;
+}
+
+
+/**
+ * Get the values of all joints
+ *
+ * This is the inverse of "setJoints()", converting the DH
+ * parameters back into the units of the joint values.
+ *
+ * @param[out] values Array into which the value of each joint is saved
+ */
+void SerialKinematics::getJoints(float *values) {
+	for (uint8_t i = 0; i < dhListLength; i++) {
+		values[i] = jointParameter(i);
+		if (jointList != NULL) values[i] = (values[i] - jointList[i].offset) / jointList[i].scale;
+	}
+}
+
+
+/**
+ * Check if a joint is prismatic
+ *
+ * @param  joint The joint number
+ * @return True if prismatic, false if revolute
+ */
+bool SerialKinematics::prismatic(uint8_t joint) {
+	return jointList != NULL && jointList[joint].type == joint_prismatic;
+}
+
+
+/**
+ * Get the column of the DH parameter which is set by a joint
+ *
+ * @param  joint The joint number
+ * @return 2 for prismatic joints (d), 3 for revolute joints (omega)
+ */
+uint8_t SerialKinematics::jointColumn(uint8_t joint) {
+	return prismatic(joint)? 2 : 3;
+}
+
+
+/**
+ * Get the DH parameter which is set by a joint
+ *
+ * @param  joint The joint number
+ * @return The value of "d" for prismatic joints, or "omega" for revolute joints
+ */
+float SerialKinematics::jointParameter(uint8_t joint) {
+	return prismatic(joint)? dhParamList[joint].d : dhParamList[joint].omega;
+}
+
+
+/**
+ * Convert the limits of a joint descriptor into DH parameter units
+ *
+ * @param[in]  joint    The joint number
+ * @param[out] minValue The lower limit of the DH parameter
+ * @param[out] maxValue The upper limit of the DH parameter
+ */
+void SerialKinematics::parameterLimits(uint8_t joint, float &minValue, float &maxValue) {
+	const struct JointDescriptor &descriptor = jointList[joint];
+	minValue = descriptor.minValue * descriptor.scale + descriptor.offset;
+	maxValue = descriptor.maxValue * descriptor.scale + descriptor.offset;
+
+	// A negative scale swaps the limits
+	if (minValue > maxValue) {
+		float temp = minValue;
+		minValue = maxValue;
+		maxValue = temp;
+	}
+}
+
+
 /**
  * Get the value of a Denavit Hartenberg parameter
  *
@@ -0,0 +1,240 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * Compile-Time Forward Kinematics for Serial Manipulators
+ *
+ * @file      StaticKinematics.hpp
+ * @brief     Forward kinematics for arms with a fixed DH table
+ * @author    Simon Bluett
+ * @website   https://wired.chillibasket.com/
+ *
+ * @copyright Copyright (C) 2026 - MIT License
+ * @date      18th October 2026
+ * @version   1.0
+ *
+ * If the geometry of the arm never changes, the DH parameters (apart
+ * from the joint angles) can be given to the compiler as constants.
+ * The whole chain is then expanded into one straight-line function:
+ * the cos and sin of each alpha are calculated at compile time, and
+ * any multiplications by 0 or ±1 are removed.
+ *
+ * Example:
+ *   STATIC_DH_ROW(Base,  0, -PI/2.0, 4.5, dh_distal);
+ *   STATIC_DH_ROW(Upper, 9.5,     0,   0, dh_distal);
+ *   typedef StaticKinematics<Base, Upper> Arm;
+ *   Arm::forwardKinematics(transform, jointAngles);
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef STATIC_KINEMATICS_HPP
+#define STATIC_KINEMATICS_HPP
+
+// RigidTransform and the DH conventions
+#include "SerialKinematics.hpp"
+
+/**
+ * Force a function to be inlined, so that the constant
+ * parameters of each joint are visible to the optimiser
+ */
+#define STATIC_KINEMATICS_INLINE inline __attribute__((always_inline))
+
+/**
+ * Define a DH row with constant parameters
+ *
+ * @param name       Name of the row type
+ * @param a_         Link length
+ * @param alpha_     Link twist (radians)
+ * @param d_         Link offset
+ * @param convention dh_distal or dh_proximal
+ */
+#define STATIC_DH_ROW(name, a_, alpha_, d_, convention_) \
+	struct name { \
+		static constexpr float a() { return a_; } \
+		static constexpr float alpha() { return alpha_; } \
+		static constexpr float d() { return d_; } \
+		static constexpr uint8_t convention() { return convention_; } \
+	}
+
+
+/**
+ * Compile-time cosine and sine (Taylor series, calculated as doubles)
+ *
+ * Only used for the constant alpha parameters; the functions are
+ * written as single return statements so that they work in C++11
+ */
+constexpr double constTaylor(double x2, uint8_t k, double term) {
+	return (k > 30)? 0 : term + constTaylor(x2, k + 2, -term * x2 / ((k + 1) * (k + 2)));
+}
+
+constexpr double constWrap(double x) {
+	return x - 6.283185307179586 * (long) (x / 6.283185307179586 + ((x >= 0)? 0.5 : -0.5));
+}
+
+constexpr double constCos(double x) {
+	return constTaylor(constWrap(x) * constWrap(x), 0, 1);
+}
+
+constexpr double constSin(double x) {
+	return constWrap(x) * constTaylor(constWrap(x) * constWrap(x), 1, 1);
+}
+
+/**
+ * Round values which are within 1e-6 of 0 or ±1, since an alpha of
+ * "PI/2.0" does not give exactly zero due to the precision of PI
+ */
+constexpr float constSnap(double x) {
+	return (x > -1e-6 && x < 1e-6)? 0 : (x > 1 - 1e-6)? 1 : (x < -1 + 1e-6)? -1 : x;
+}
+
+
+/**
+ * Multiply a variable by a constant, removing the multiplication if
+ * the constant is 0 or ±1. A zero is returned as -0.0, which the
+ * compiler can remove from additions (unlike +0.0)
+ *
+ * @param  (constant) The constant value
+ * @param  (value)    The variable
+ * @return The product
+ */
+STATIC_KINEMATICS_INLINE float constMul(float constant, float value) {
+	return (constant == 0)? -0.0f : (constant == 1)? value : (constant == -1)? -value : constant * value;
+}
+
+
+/**
+ * Operations for one joint with constant parameters
+ */
+template <class Row>
+struct StaticJoint {
+	static constexpr float cosAlpha() { return constSnap(constCos(Row::alpha())); }
+	static constexpr float sinAlpha() { return constSnap(constSin(Row::alpha())); }
+
+	/**
+	 * Calculate the cos and sin of the joint angle
+	 */
+	static STATIC_KINEMATICS_INLINE void sinCos(float angle, float &sinValue, float &cosValue) {
+		#ifdef SERIAL_KINEMATICS_FAST_TRIG
+			fastSinCos(angle, sinValue, cosValue);
+		#else
+			sinValue = sin(angle);
+			cosValue = cos(angle);
+		#endif
+	}
+
+	/**
+	 * Set the transformation to the transformation of this joint
+	 *
+	 * @param[out] transform The transformation to be set
+	 * @param[in]  omega     The joint angle
+	 */
+	static STATIC_KINEMATICS_INLINE void set(struct RigidTransform &transform, float omega) {
+		float co, so;
+		sinCos(omega, so, co);
+
+		if (Row::convention() == dh_proximal) {
+			transform.R[0][0] = co;
+			transform.R[0][1] = -so;
+			transform.R[0][2] = 0;
+			transform.R[1][0] = constMul(cosAlpha(), so);
+			transform.R[1][1] = constMul(cosAlpha(), co);
+			transform.R[1][2] = -sinAlpha();
+			transform.R[2][0] = constMul(sinAlpha(), so);
+			transform.R[2][1] = constMul(sinAlpha(), co);
+			transform.R[2][2] = cosAlpha();
+			transform.p[0] = Row::a();
+			transform.p[1] = -sinAlpha() * Row::d();
+			transform.p[2] = cosAlpha() * Row::d();
+		} else {
+			transform.R[0][0] = co;
+			transform.R[0][1] = -constMul(cosAlpha(), so);
+			transform.R[0][2] = constMul(sinAlpha(), so);
+			transform.R[1][0] = so;
+			transform.R[1][1] = constMul(cosAlpha(), co);
+			transform.R[1][2] = -constMul(sinAlpha(), co);
+			transform.R[2][0] = 0;
+			transform.R[2][1] = sinAlpha();
+			transform.R[2][2] = cosAlpha();
+			transform.p[0] = constMul(Row::a(), co);
+			transform.p[1] = constMul(Row::a(), so);
+			transform.p[2] = Row::d();
+		}
+	}
+
+	/**
+	 * Multiply the transformation by the transformation of this joint
+	 *
+	 * @param[in,out] transform The transformation to be updated
+	 * @param[in]     omega     The joint angle
+	 */
+	static STATIC_KINEMATICS_INLINE void multiply(struct RigidTransform &transform, float omega) {
+		float co, so;
+		sinCos(omega, so, co);
+
+		for (uint8_t i = 0; i < 3; i++) {
+			float *row = transform.R[i];
+
+			if (Row::convention() == dh_proximal) {
+				float v1 = constMul(cosAlpha(), row[1]) + constMul(sinAlpha(), row[2]);
+				float v2 = constMul(cosAlpha(), row[2]) - constMul(sinAlpha(), row[1]);
+
+				transform.p[i] += constMul(Row::a(), row[0]) + constMul(Row::d(), v2);
+				float r0 = row[0];
+				row[0] = r0 * co + v1 * so;
+				row[1] = v1 * co - r0 * so;
+				row[2] = v2;
+			} else {
+				float x = row[0] * co + row[1] * so;
+				float u = row[1] * co - row[0] * so;
+
+				transform.p[i] += constMul(Row::a(), x) + constMul(Row::d(), row[2]);
+				row[0] = x;
+				row[1] = constMul(cosAlpha(), u) + constMul(sinAlpha(), row[2]);
+				row[2] = constMul(cosAlpha(), row[2]) - constMul(sinAlpha(), u);
+			}
+		}
+	}
+};
+
+
+/**
+ * Multiply the remaining joints of the chain, one after the other
+ */
+template <uint8_t Index, class... Rows>
+struct StaticChain {
+	static STATIC_KINEMATICS_INLINE void multiply(struct RigidTransform &, const float *) {}
+};
+
+template <uint8_t Index, class Row, class... Rest>
+struct StaticChain<Index, Row, Rest...> {
+	static STATIC_KINEMATICS_INLINE void multiply(struct RigidTransform &transform, const float *jointValues) {
+		StaticJoint<Row>::multiply(transform, jointValues[Index]);
+		StaticChain<Index + 1, Rest...>::multiply(transform, jointValues);
+	}
+};
+
+
+/**
+ * @class StaticKinematics
+ *
+ * Forward kinematics for a chain of rows defined using "STATIC_DH_ROW".
+ * All functions are static, so no object needs to be created.
+ */
+template <class First, class... Rest>
+class StaticKinematics {
+public:
+	/**
+	 * Number of joints in the chain
+	 */
+	static constexpr uint8_t length() { return 1 + sizeof...(Rest); }
+
+	/**
+	 * Calculate the forward kinematics of the whole chain
+	 *
+	 * @param[out] transform   The transformation of the end effector
+	 * @param[in]  jointValues The angle of each joint, in order (length() values)
+	 */
+	static void forwardKinematics(struct RigidTransform &transform, const float *jointValues) {
+		StaticJoint<First>::set(transform, jointValues[0]);
+		StaticChain<1, Rest...>::multiply(transform, jointValues);
+	}
+};
+
+
+#endif /* STATIC_KINEMATICS_HPP */
@@ -20,6 +20,8 @@
  * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "SerialKinematics.hpp"
+#include "StaticKinematics.hpp"
+#include "FastTrig.hpp"
 
 
 // Define the robot manipulator arm
@@ -33,9 +35,68 @@ struct DhRow dhParameters[5] = {{   0, -PI/2.0,  4.5, -PI/2.0},
 // Supply the DH parameter list to the kinematics object
 SerialKinematics kinematics(dhParameters, 5);
 
+// A 6-joint arm with a spherical wrist, for the analytic inverse kinematics
+struct DhRow wristParameters[6] = {{   0, -PI/2.0,  4.5,       0},
+                                   { 9.5,       0,    0, -PI/2.0},
+                                   {   0,  PI/2.0,    0,  PI/2.0},
+                                   {   0, -PI/2.0,   11,       0},
+                                   {   0,  PI/2.0,    0,       0},
+                                   {   0,       0,    3,       0}};
+
+SerialKinematics wristKinematics(wristParameters, 6);
+
+// Arms with prismatic joints in both DH conventions, for the Jacobian check
+// Denavit Hartenberg Parameters       a,   alpha,    d,   omega,  convention
+struct DhRow distalParameters[4] =   {{   0, -PI/2.0,    4,       0, dh_distal},
+                                      {   0,  PI/2.0,    5,       0, dh_distal},
+                                      {   8,       0,    0,  PI/4.0, dh_distal},
+                                      {   0,       0,    3,       0, dh_distal}};
+
+struct DhRow proximalParameters[4] = {{   0,       0,  4.5,       0, dh_proximal},
+                                      {   0, -PI/2.0,    0, -PI/2.0, dh_proximal},
+                                      { 9.5,       0,    0,       0, dh_proximal},
+                                      {   0, -PI/2.0,    6,       0, dh_proximal}};
+
+//                                    type,            offset, scale, min, max
+const struct JointDescriptor distalJoints[4] =   {{joint_revolute,  0, 1, 0, 0},
+                                                  {joint_prismatic, 0, 1, 0, 0},
+                                                  {joint_revolute,  0, 1, 0, 0},
+                                                  {joint_prismatic, 0, 1, 0, 0}};
+
+const struct JointDescriptor proximalJoints[4] = {{joint_revolute,  0, 1, 0, 0},
+                                                  {joint_revolute,  0, 1, 0, 0},
+                                                  {joint_revolute,  0, 1, 0, 0},
+                                                  {joint_prismatic, 0, 1, 0, 0}};
+
+SerialKinematics distalKinematics(distalParameters, 4);
+SerialKinematics proximalKinematics(proximalParameters, 4);
+
+// The same arm as "dhParameters", with the geometry fixed at compile time
+//            Name       a,   alpha,    d,  convention
+STATIC_DH_ROW(Base,       0, -PI/2.0,  4.5, dh_distal);
+STATIC_DH_ROW(Shoulder, 9.5,       0,    0, dh_distal);
+STATIC_DH_ROW(Elbow,     11,       0,    0, dh_distal);
+STATIC_DH_ROW(Wrist,      0, -PI/2.0,    0, dh_distal);
+STATIC_DH_ROW(Tool,       0,       0, 10.5, dh_distal);
+
+typedef StaticKinematics<Base, Shoulder, Elbow, Wrist, Tool> StaticArm;
+
 
 int currentTest = 0;
 
+#define BENCHMARK_LOOPS 1000
+#define SWEEP_STEPS 100
+#define JACOBIAN_POSES 100
+
+// Number of joint configurations in the batch benchmark
+#if defined(__AVR__)
+#define BATCH_SIZE 8
+#else
+#define BATCH_SIZE 10000
+#endif
+
+float solution[5];
+
 
 /**
  * Setup Function
@@ -44,10 +105,418 @@ void setup() {
 	Serial.begin(115200);
 	while(!Serial);
 
+	trigBenchmark();
+	benchmark();
+	staticBenchmark();
+	batchBenchmark();
+	printJacobian();
+	verifyJacobian();
+	inverseKinematicsSweep();
+	analyticSweep();
 	testScript();
 }
 
 
+/**
+ * Compare the analytic and iterative inverse kinematics of the 6-joint arm
+ */
+void analyticSweep() {
+	const float home[6] = {0, -PI/2.0, PI/2.0, 0, 0, 0};
+	struct IkOptions options;
+
+	unsigned long analyticTime = 0;
+	unsigned long iterativeTime = 0;
+	int analyticSolved = 0;
+	int iterativeSolved = 0;
+
+	for (int step = 0; step < SWEEP_STEPS; step++) {
+
+		// Find a reachable target pose
+		float phase = step * 2.0 * PI / SWEEP_STEPS;
+		for (int joint = 0; joint < 6; joint++) {
+			wristKinematics.setParameter(home[joint] + 0.6 * sin(phase + joint), joint, 3);
+		}
+		struct RigidTransform target;
+		wristKinematics.forwardKinematics(target);
+
+		// Solve from the home position using both methods
+		for (int joint = 0; joint < 6; joint++) wristKinematics.setParameter(home[joint], joint, 3);
+		unsigned long stopwatch = micros();
+		if (wristKinematics.analyticInverseKinematics(target) == ik_success) analyticSolved++;
+		analyticTime += micros() - stopwatch;
+
+		for (int joint = 0; joint < 6; joint++) wristKinematics.setParameter(home[joint], joint, 3);
+		stopwatch = micros();
+		if (wristKinematics.inverseKinematics(target, options) == ik_success) iterativeSolved++;
+		iterativeTime += micros() - stopwatch;
+	}
+
+	Serial.print("Analytic IK solved: ");     Serial.print(analyticSolved); Serial.print("/"); Serial.println(SWEEP_STEPS);
+	Serial.print("Analytic IK time (us): ");  Serial.println(analyticTime / float(SWEEP_STEPS));
+	Serial.print("Iterative IK solved: ");    Serial.print(iterativeSolved); Serial.print("/"); Serial.println(SWEEP_STEPS);
+	Serial.print("Iterative IK time (us): "); Serial.println(iterativeTime / float(SWEEP_STEPS));
+}
+
+
+/**
+ * Solve inverse kinematics for a sweep of reachable poses
+ *
+ * The target poses are found using forward kinematics, by moving each
+ * joint along a sine wave. Each solve starts from the previous solution,
+ * which is how the solver would be used when following a path.
+ */
+void inverseKinematicsSweep() {
+	const float home[5] = {-PI/2.0, -PI/2.0, PI/2.0, 0, 0};
+	struct IkOptions options;
+	options.maxTime = 5000;
+
+	unsigned long totalTime = 0;
+	unsigned long totalIterations = 0;
+	int solved = 0;
+
+	for (int step = 0; step < SWEEP_STEPS; step++) {
+
+		// Find a reachable target pose
+		float phase = step * 2.0 * PI / SWEEP_STEPS;
+		for (int joint = 0; joint < 5; joint++) {
+			kinematics.setParameter(home[joint] + 0.6 * sin(phase + joint), joint, 3);
+		}
+		struct RigidTransform target;
+		kinematics.forwardKinematics(target);
+
+		// Start from the previous solution (or the home position)
+		for (int joint = 0; joint < 5; joint++) {
+			kinematics.setParameter((step == 0)? home[joint] : solution[joint], joint, 3);
+		}
+
+		uint16_t iterations = 0;
+		unsigned long stopwatch = micros();
+		uint8_t status = kinematics.inverseKinematics(target, options, &iterations);
+		totalTime += micros() - stopwatch;
+		totalIterations += iterations;
+		if (status == ik_success) solved++;
+
+		for (int joint = 0; joint < 5; joint++) solution[joint] = kinematics.getParameter(joint, 3);
+	}
+
+	Serial.print("IK solved: ");             Serial.print(solved); Serial.print("/"); Serial.println(SWEEP_STEPS);
+	Serial.print("IK average iterations: "); Serial.println(totalIterations / float(SWEEP_STEPS));
+	Serial.print("IK average time (us): ");  Serial.println(totalTime / float(SWEEP_STEPS));
+
+	// Return to the home position for the tests
+	for (int joint = 0; joint < 5; joint++) kinematics.setParameter(home[joint], joint, 3);
+}
+
+
+/**
+ * Print the Jacobian of the current manipulator pose
+ */
+void printJacobian() {
+	float jac[5][6];
+	kinematics.jacobian(jac);
+
+	Serial.println("Jacobian (vx, vy, vz, wx, wy, wz):");
+	for (int joint = 0; joint < 5; joint++) {
+		Serial.print("Joint "); Serial.print(joint); Serial.print(": ");
+		for (int i = 0; i < 6; i++) {
+			Serial.print(jac[joint][i]); Serial.print(", \t");
+		}
+		Serial.println();
+	}
+}
+
+
+/**
+ * Check the Jacobian against finite differences of the forward kinematics
+ *
+ * Covers revolute and prismatic joints in both DH conventions. The errors
+ * are printed as absolute values and relative to the largest Jacobian entry.
+ */
+void verifyJacobian() {
+	distalKinematics.setJointDescriptors(distalJoints);
+	proximalKinematics.setJointDescriptors(proximalJoints);
+
+	const bool revolute[5] = {true, true, true, true, true};
+	const bool distalTypes[4] = {true, false, true, false};
+	const bool proximalTypes[4] = {true, true, true, false};
+
+	Serial.println("Arm, Max Jacobian error, Max relative error");
+	checkJacobian("Revolute distal", kinematics, revolute, 5);
+	checkJacobian("Prismatic distal", distalKinematics, distalTypes, 4);
+	checkJacobian("Prismatic proximal", proximalKinematics, proximalTypes, 4);
+}
+
+
+/**
+ * Compare each Jacobian row to the change of the end effector pose when
+ * the joint is moved by a small step in each direction, at random poses
+ *
+ * @param name     Label printed in front of the results
+ * @param arm      The manipulator arm to check
+ * @param revolute Whether each joint is revolute (true) or prismatic (false)
+ * @param joints   Number of joints of the arm
+ */
+void checkJacobian(const char *name, SerialKinematics &arm, const bool *revolute, uint8_t joints) {
+	const float step = 2e-3;
+	float home[8];
+	float jac[8][6];
+	float maxError = 0;
+	float maxValue = 0;
+
+	for (uint8_t i = 0; i < joints; i++) home[i] = arm.getParameter(i, revolute[i]? 3 : 2);
+
+	for (int pose = 0; pose < JACOBIAN_POSES; pose++) {
+
+		// Random angles within +-PI, and offsets within +-5 of the home position
+		for (uint8_t i = 0; i < joints; i++) {
+			const float range = revolute[i]? PI : 5;
+			arm.setParameter(home[i] + range * random(-1000, 1001) / 1000.0, i, revolute[i]? 3 : 2);
+		}
+		arm.jacobian(jac);
+
+		for (uint8_t i = 0; i < joints; i++) {
+			const uint8_t col = revolute[i]? 3 : 2;
+			const float value = arm.getParameter(i, col);
+			struct RigidTransform plus, minus;
+
+			arm.setParameter(value + step, i, col);
+			arm.forwardKinematics(plus);
+			arm.setParameter(value - step, i, col);
+			arm.forwardKinematics(minus);
+			arm.setParameter(value, i, col);
+
+			// Linear velocity from the change in position, angular
+			// velocity from the skew part of R(+step) * R(-step)^T
+			float diff[6];
+			float dR[3][3];
+			for (uint8_t r = 0; r < 3; r++) {
+				diff[r] = (plus.p[r] - minus.p[r]) / (2 * step);
+				for (uint8_t c = 0; c < 3; c++) {
+					dR[r][c] = plus.R[r][0] * minus.R[c][0] + plus.R[r][1] * minus.R[c][1] + plus.R[r][2] * minus.R[c][2];
+				}
+			}
+			diff[3] = (dR[2][1] - dR[1][2]) / (4 * step);
+			diff[4] = (dR[0][2] - dR[2][0]) / (4 * step);
+			diff[5] = (dR[1][0] - dR[0][1]) / (4 * step);
+
+			for (uint8_t k = 0; k < 6; k++) {
+				maxError = max(maxError, abs(jac[i][k] - diff[k]));
+				maxValue = max(maxValue, abs(jac[i][k]));
+			}
+		}
+	}
+
+	for (uint8_t i = 0; i < joints; i++) arm.setParameter(home[i], i, revolute[i]? 3 : 2);
+
+	Serial.print(name); Serial.print(", ");
+	Serial.print(maxError, 6); Serial.print(", ");
+	Serial.println(maxError / maxValue, 6);
+}
+
+
+/**
+ * Compare the speed and accuracy of the standard and fast trig functions
+ */
+void trigBenchmark() {
+	const float ranges[4] = {PI/4.0, 2*PI, 100, 10000};
+	volatile float sink = 0;
+
+	// Accuracy compared to the standard functions, in each range
+	// (on AVR "double" is the same as "float", so this is float vs float)
+	Serial.println("Range, Max sin error, Max cos error");
+	for (int r = 0; r < 4; r++) {
+		float maxSinError = 0;
+		float maxCosError = 0;
+		for (int i = 0; i <= BENCHMARK_LOOPS; i++) {
+			float angle = ranges[r] * (2.0 * i / BENCHMARK_LOOPS - 1);
+			float s, c;
+			fastSinCos(angle, s, c);
+			float sinError = abs(s - sin(angle));
+			float cosError = abs(c - cos(angle));
+			if (sinError > maxSinError) maxSinError = sinError;
+			if (cosError > maxCosError) maxCosError = cosError;
+		}
+		Serial.print(ranges[r]); Serial.print(", ");
+		Serial.print(maxSinError, 8); Serial.print(", ");
+		Serial.println(maxCosError, 8);
+	}
+
+	// Speed of calculating both the sine and cosine
+	unsigned long libraryTime = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		float angle = i * 0.01;
+		sink = sin(angle) + cos(angle);
+	}
+	libraryTime = micros() - libraryTime;
+
+	unsigned long fastTime = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		float angle = i * 0.01;
+		float s, c;
+		fastSinCos(angle, s, c);
+		sink = s + c;
+	}
+	fastTime = micros() - fastTime;
+
+	Serial.print("sin() + cos() (us): "); Serial.println(libraryTime / float(BENCHMARK_LOOPS));
+	Serial.print("fastSinCos() (us): ");  Serial.println(fastTime / float(BENCHMARK_LOOPS));
+}
+
+
+/**
+ * Compare the speed of the 4x4 matrix and rigid transform calculations
+ */
+void benchmark() {
+	BLA::Matrix<4,4> tmatrix;
+	BLA::Matrix<4,4> tmatrixRigid;
+	struct RigidTransform transform;
+
+	// Time the full 4x4 matrix calculation
+	unsigned long matrixTime = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		kinematics.setParameter(i * 0.001, 0, 3);
+		kinematics.forwardKinematics(tmatrix);
+	}
+	matrixTime = micros() - matrixTime;
+
+	// Time the rigid transform calculation
+	unsigned long rigidTime = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		kinematics.setParameter(i * 0.001, 0, 3);
+		kinematics.forwardKinematics(transform);
+	}
+	rigidTime = micros() - rigidTime;
+
+	// Time the rigid transform calculation when only the last joint changes,
+	// so that the cached frames of the other joints can be reused
+	unsigned long cachedTime = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		kinematics.setParameter(i * 0.001, 4, 3);
+		kinematics.forwardKinematics(transform);
+	}
+	cachedTime = micros() - cachedTime;
+	kinematics.setParameter(0, 4, 3);
+	kinematics.forwardKinematics(transform);
+
+	// Check that both methods give the same result
+	kinematics.transform2tmatrix(tmatrixRigid, transform);
+	float maxError = 0;
+	for (int row = 0; row < 4; row++) {
+		for (int col = 0; col < 4; col++) {
+			float error = abs(tmatrix(row,col) - tmatrixRigid(row,col));
+			if (error > maxError) maxError = error;
+		}
+	}
+	kinematics.setParameter(-PI/2.0, 0, 3);
+
+	Serial.print("BLA::Matrix (us): ");    Serial.println(matrixTime / float(BENCHMARK_LOOPS));
+	Serial.print("RigidTransform (us): "); Serial.println(rigidTime / float(BENCHMARK_LOOPS));
+	Serial.print("Last joint only (us): "); Serial.println(cachedTime / float(BENCHMARK_LOOPS));
+	Serial.print("Max difference: ");      Serial.println(maxError, 6);
+}
+
+
+/**
+ * Compare the speed of the runtime and compile-time DH chains
+ */
+void staticBenchmark() {
+	struct RigidTransform runtimeTransform;
+	struct RigidTransform staticTransform;
+	float angles[5];
+
+	// Time the runtime class, with all joints changing
+	unsigned long runtimeTime = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		for (uint8_t j = 0; j < 5; j++) kinematics.setParameter(i * 0.001 + j, j, 3);
+		kinematics.forwardKinematics(runtimeTransform);
+	}
+	runtimeTime = micros() - runtimeTime;
+
+	// Time the compile-time chain
+	unsigned long staticTime = micros();
+	for (int i = 0; i < BENCHMARK_LOOPS; i++) {
+		for (uint8_t j = 0; j < 5; j++) angles[j] = i * 0.001 + j;
+		StaticArm::forwardKinematics(staticTransform, angles);
+	}
+	staticTime = micros() - staticTime;
+
+	// Check that both give the same result
+	float maxError = 0;
+	for (uint8_t row = 0; row < 3; row++) {
+		for (uint8_t col = 0; col < 3; col++) {
+			float error = abs(runtimeTransform.R[row][col] - staticTransform.R[row][col]);
+			if (error > maxError) maxError = error;
+		}
+		float error = abs(runtimeTransform.p[row] - staticTransform.p[row]);
+		if (error > maxError) maxError = error;
+	}
+
+	// Restore the original joint angles
+	kinematics.setParameter(-PI/2.0, 0, 3);
+	kinematics.setParameter(-PI/2.0, 1, 3);
+	kinematics.setParameter( PI/2.0, 2, 3);
+	kinematics.setParameter(      0, 3, 3);
+	kinematics.setParameter(      0, 4, 3);
+
+	Serial.print("Runtime chain (us): ");     Serial.println(runtimeTime / float(BENCHMARK_LOOPS));
+	Serial.print("Compile-time chain (us): "); Serial.println(staticTime / float(BENCHMARK_LOOPS));
+	Serial.print("Max difference: ");         Serial.println(maxError, 6);
+}
+
+
+/**
+ * Compare the speed of the batch calculation with a loop over the configurations
+ */
+void batchBenchmark() {
+	static float angles[5][BATCH_SIZE];
+	static float x[BATCH_SIZE], y[BATCH_SIZE], z[BATCH_SIZE];
+	static float loopX[BATCH_SIZE], loopY[BATCH_SIZE], loopZ[BATCH_SIZE];
+	const float *jointValues[5] = {angles[0], angles[1], angles[2], angles[3], angles[4]};
+	struct RigidTransform transform;
+	float maxError = 0;
+
+	for (unsigned long i = 0; i < BATCH_SIZE; i++) {
+		for (uint8_t j = 0; j < 5; j++) angles[j][i] = i * 0.001 + j;
+	}
+
+	// Time one configuration at a time
+	unsigned long loopTime = micros();
+	for (unsigned long i = 0; i < BATCH_SIZE; i++) {
+		for (uint8_t j = 0; j < 5; j++) kinematics.setParameter(angles[j][i], j, 3);
+		kinematics.forwardKinematics(transform);
+		loopX[i] = transform.p[0];
+		loopY[i] = transform.p[1];
+		loopZ[i] = transform.p[2];
+	}
+	loopTime = micros() - loopTime;
+
+	// Time all configurations at once
+	unsigned long batchTime = micros();
+	kinematics.forwardKinematicsBatch(jointValues, BATCH_SIZE, x, y, z);
+	batchTime = micros() - batchTime;
+
+	// Check that both give the same result
+	for (unsigned long i = 0; i < BATCH_SIZE; i++) {
+		float errors[3] = {abs(x[i] - loopX[i]), abs(y[i] - loopY[i]), abs(z[i] - loopZ[i])};
+		for (uint8_t e = 0; e < 3; e++) {
+			if (errors[e] > maxError) maxError = errors[e];
+		}
+	}
+
+	// Restore the original joint angles
+	kinematics.setParameter(-PI/2.0, 0, 3);
+	kinematics.setParameter(-PI/2.0, 1, 3);
+	kinematics.setParameter( PI/2.0, 2, 3);
+	kinematics.setParameter(      0, 3, 3);
+	kinematics.setParameter(      0, 4, 3);
+
+	Serial.print("Batch size: ");            Serial.println(BATCH_SIZE);
+	Serial.print("Loop (us per config): ");  Serial.println(loopTime / float(BATCH_SIZE), 4);
+	Serial.print("Batch (us per config): "); Serial.println(batchTime / float(BATCH_SIZE), 4);
+	Serial.print("Max difference: ");        Serial.println(maxError, 6);
+}
+
+
 /**
  * Perform Tests
  */
@@ -97,6 +566,7 @@ void testScript() {
 	BLA::Matrix<4,4> tmatrix;
 	float coordinates[3] { 0 };
 	float eulerangles[3] { 0 };
+	float quaternion[4] { 0 };
 
 	// Start timer
 	unsigned long stopwatch = micros();
@@ -107,6 +577,7 @@ void testScript() {
 	// Convert the matrix to the coordinates and orientation of the end effector
 	kinematics.tmatrix2coordinates(coordinates, tmatrix);
 	kinematics.tmatrix2euler(eulerangles, tmatrix);
+	kinematics.tmatrix2quaternion(quaternion, tmatrix);
 
 	// End the timer
 	stopwatch = micros() - stopwatch;
@@ -120,6 +591,10 @@ void testScript() {
 	Serial.print((eulerangles[0] * 4068) / 71.0); Serial.print(" y, \t");
 	Serial.print((eulerangles[1] * 4068) / 71.0); Serial.print(" p, \t");
 	Serial.print((eulerangles[2] * 4068) / 71.0); Serial.print(" r, \t");
+	Serial.print(quaternion[0], 4); Serial.print(" qw, ");
+	Serial.print(quaternion[1], 4); Serial.print(" qx, ");
+	Serial.print(quaternion[2], 4); Serial.print(" qy, ");
+	Serial.print(quaternion[3], 4); Serial.print(" qz, \t");
 	Serial.println(stopwatch);
 }
 
@@ -0,0 +1,150 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * BENCHMARK SKETCH FOR THE SERVO TRAJECTORY CONTROLLER CLASSES
+ *
+ * Code by: Simon Bluett
+ * Website: https://wired.chillibasket.com
+ * Version: 1.0
+ * Date:    18th October 2026
+ * Copyright (C) 2026, MIT License
+ *
+ * This sketch compares the floating-point "Trajectory" class
+ * with the fixed-point "FixedTrajectory" class. Both controllers
+ * perform the same sequence of moves as "trajectory-example.ino"
+ * at an update rate of 100Hz.
+ *
+ * 1. Accuracy: the maximum difference in position and velocity
+ *    between the two classes is printed for each move.
+ * 2. Speed: the average time and number of CPU clock cycles
+ *    required for each update are printed for both classes.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+
+// --- Include the libraries ---
+// Make sure that "trajectory.h" and "trajectory-fixed.h" are
+// included in the same folder as the Arduino sketch
+#include "trajectory.h"
+#include "trajectory-fixed.h"
+
+
+// --- Define global variables ---
+#define UPDATE_FREQUENCY 100
+#define UPDATE_TIME (1000 / UPDATE_FREQUENCY)
+#define BENCHMARK_UPDATES 2000
+
+Trajectory floatTrajectory(60, 40, 34);
+FixedTrajectory fixedTrajectory(60, 40, 34, 0.1, UPDATE_FREQUENCY);
+
+
+/**
+ * Start the next move on both controllers
+ *
+ * @param  (moveNumber) The move to start
+ * @return False if all moves have been completed
+ */
+bool startMove(int moveNumber) {
+	switch (moveNumber) {
+		case 0: floatTrajectory.setTargetPos(180);     fixedTrajectory.setTargetPos(180);     break;
+		case 1: floatTrajectory.setTargetPos(20);      fixedTrajectory.setTargetPos(20);      break;
+		case 2: floatTrajectory.setTargetPos(180, 5);  fixedTrajectory.setTargetPos(180, 5);  break;
+		case 3: floatTrajectory.setTargetPos(20, 8.5); fixedTrajectory.setTargetPos(20, 8.5); break;
+		default: return false;
+	}
+	return true;
+}
+
+
+/**
+ * Compare the position and velocity output of both classes
+ */
+void accuracyTest() {
+	floatTrajectory.reset(20);
+	fixedTrajectory.reset(20);
+
+	Serial.println("Move, Float Ticks, Fixed Ticks, Max Pos Error, Max Vel Error");
+
+	for (int moveNumber = 0; startMove(moveNumber); moveNumber++) {
+		float maxPosError = 0;
+		float maxVelError = 0;
+		unsigned long floatTicks = 0;
+		unsigned long fixedTicks = 0;
+
+		while (!floatTrajectory.ready() || !fixedTrajectory.ready()) {
+			if (!floatTrajectory.ready()) {
+				floatTrajectory.update(UPDATE_TIME);
+				floatTicks++;
+			}
+			if (!fixedTrajectory.ready()) {
+				fixedTrajectory.step();
+				fixedTicks++;
+			}
+
+			float posError = abs(floatTrajectory.getPos() - fixedTrajectory.getPos());
+			float velError = abs(floatTrajectory.getVel() - fixedTrajectory.getVel());
+			if (posError > maxPosError) maxPosError = posError;
+			if (velError > maxVelError) maxVelError = velError;
+		}
+
+		Serial.print(moveNumber); Serial.print(", ");
+		Serial.print(floatTicks); Serial.print(", ");
+		Serial.print(fixedTicks); Serial.print(", ");
+		Serial.print(maxPosError, 5); Serial.print(", ");
+		Serial.println(maxVelError, 5);
+	}
+}
+
+
+/**
+ * Measure the average duration of one update
+ */
+void speedTest() {
+	floatTrajectory.reset(20);
+	fixedTrajectory.reset(20);
+	floatTrajectory.setTargetPos(180);
+	fixedTrajectory.setTargetPos(180);
+
+	unsigned long floatTime = micros();
+	for (int i = 0; i < BENCHMARK_UPDATES; i++) {
+		if (floatTrajectory.ready()) floatTrajectory.setTargetPos((i & 1)? 20 : 180);
+		floatTrajectory.update(UPDATE_TIME);
+	}
+	floatTime = micros() - floatTime;
+
+	unsigned long fixedTime = micros();
+	for (int i = 0; i < BENCHMARK_UPDATES; i++) {
+		if (fixedTrajectory.ready()) fixedTrajectory.setTargetPos((i & 1)? 20 : 180);
+		fixedTrajectory.step();
+	}
+	fixedTime = micros() - fixedTime;
+
+	Serial.println("Class, Time per update (us), Cycles per update");
+	Serial.print("Trajectory, ");
+	Serial.print(floatTime / float(BENCHMARK_UPDATES)); Serial.print(", ");
+	Serial.println(floatTime * (F_CPU / 1000000UL) / BENCHMARK_UPDATES);
+	Serial.print("FixedTrajectory, ");
+	Serial.print(fixedTime / float(BENCHMARK_UPDATES)); Serial.print(", ");
+	Serial.println(fixedTime * (F_CPU / 1000000UL) / BENCHMARK_UPDATES);
+}
+
+
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * SETUP
+ * * * * * * * * * * * * * * * * * * * * * * */
+void setup() {
+
+	Serial.begin(115200);
+	while(!Serial);
+	Serial.println("Starting benchmark");
+
+	accuracyTest();
+	speedTest();
+
+	Serial.println("Benchmark completed");
+}
+
+
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * LOOP
+ * * * * * * * * * * * * * * * * * * * * * * */
+void loop() {
+	// Empty
+}
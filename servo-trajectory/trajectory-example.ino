@@ -151,13 +151,23 @@ void loop() {
 		 */
 		//myservo.writeMicroseconds(map(currentAngle, 0, 180, MIN_PWM, MAX_PWM));
 
-		// Output the target position, along with the current position and velocity
+		/**
+		 * When the trajectory is used as the input of a PID controller, the
+		 * velocity and acceleration can be added as feedforward terms. The
+		 * gains KV and KA depend on the motor and load being controlled.
+		 */
+		//TrajectorySetpoint setpoint = servoTrajectory.getSetpoint();
+		//float output = pid.update(setpoint.pos, encoderAngle) + KV * setpoint.vel + KA * setpoint.acc;
+
+		// Output the target position, along with the current position, velocity and acceleration
 		Serial.print("Target: ");
 		Serial.print(servoTrajectory.getTarget());
 		Serial.print(", Angle: ");
 		Serial.print(servoTrajectory.getPos());
 		Serial.print(", Velocity: ");
-		Serial.println(servoTrajectory.getVel());
+		Serial.print(servoTrajectory.getVel());
+		Serial.print(", Acceleration: ");
+		Serial.println(servoTrajectory.getCurAcc());
 
 		// Only once the servo has reached the desired position, complete the next move
 		if (servoTrajectory.ready()) {
@@ -0,0 +1,514 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * FIXED-POINT TRAJECTORY CONTROLLER CLASS
+ *
+ * Code by: Simon Bluett
+ * Website: https://wired.chillibasket.com
+ * Version: 1.0
+ * Date:    18th October 2026
+ * Copyright (C) 2026, MIT License
+ *
+ * This class produces the same trapezoidal velocity profile
+ * as the floating-point "Trajectory" class, but is designed
+ * for 8-bit microcontrollers which do not have a floating
+ * point unit (such as the Atmega 328 on the Arduino Uno).
+ *
+ * The controller runs at a fixed update rate. All of the
+ * per-tick constants (velocity/acceleration steps and the
+ * braking distance factor) are calculated once when the
+ * limits or the update rate are set, so that each update
+ * only requires integer additions, shifts and comparisons.
+ * The timing is done using integer microseconds.
+ *
+ * Number formats used internally:
+ * - Position:              Q16.16 (units)
+ * - Velocity/acceleration: Q8.24  (units per tick, units per tick^2)
+ *
+ * @note The maximum velocity divided by the update rate must
+ *       be less than 128 units per tick, and positions must
+ *       stay within +/-32767 units.
+ * @note Requires "trajectory.h" to be in the same folder.
+ * @note At very high update rates the acceleration per tick
+ *       becomes very small, so some resolution is lost. For
+ *       a typical servo (40°/s^2 at 100Hz), the error of the
+ *       acceleration step is less than 0.01%.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef TRAJECTORY_FIXED_H
+#define TRAJECTORY_FIXED_H
+
+#include <Arduino.h>
+#include "trajectory.h"
+
+// Fixed-point scaling factors
+#define TRAJ_POS_SHIFT 16
+#define TRAJ_VEL_SHIFT 24
+#define TRAJ_POS_SCALE 65536.0
+#define TRAJ_VEL_SCALE 16777216.0
+
+// Maximum number of ticks which update() catches up on in one call
+#define TRAJ_MAX_TICKS 16
+
+
+// FIXED-POINT TRAJECTORY CLASS
+class FixedTrajectory {
+
+public:
+	// Constructors
+	FixedTrajectory(float _maxVel = 100, float _setAcc = 50, float _setDec = -1, float _thresh = 0.1, uint16_t _rate = 100);
+
+	// Set target position/velocity
+	void setTargetPos(float _target);
+	bool setTargetPos(float _target, float _time);
+	void setTargetVel(float _target);
+
+	// Get the current target position or velocity values
+	float getTarget();
+
+	// Set max velocity, acceleration, deceleration or update rate (Hz)
+	void setMaxVel(float _maxVel) { maxVel = _maxVel; updateSteps(); };
+	void setAcc(float _acc) { acc = _acc; updateSteps(); };
+	void setDec(float _dec) { dec = _dec; updateSteps(); };
+	bool setRate(uint16_t _rate);
+
+	// Get the current max velocity, accel, decel and update rate values
+	float getMaxVel() { return maxVel; };
+	float getAcc() { return acc; };
+	float getDec() { return dec; };
+	uint16_t getRate() { return rate; };
+
+	// Get the current position and velocity
+	float getPos() { return curPos * (1.0 / TRAJ_POS_SCALE); };
+	float getVel() { return curVel * (rate / TRAJ_VEL_SCALE); };
+
+	// Get the current position as a rounded integer or the raw Q16.16 value
+	int16_t getPosInt() { return (curPos + (1L << (TRAJ_POS_SHIFT - 1))) >> TRAJ_POS_SHIFT; };
+	int32_t getPosFixed() { return curPos; };
+
+	// Set the current position
+	void setPos(float newPos = 0);
+
+	// Reset the controller
+	void reset(float newPos = 0);
+
+	// Check if the controller has reached the desired position
+	bool ready() { return noTasks; };
+
+	// Advance the controller by exactly one tick (eg. from a timer interrupt)
+	int32_t step();
+
+	// Advance the controller by all ticks which have elapsed since the last update
+	float update();
+
+	// Default destructor
+	~FixedTrajectory();
+
+private:
+	void updateSteps();
+	int32_t stopSpeed(int32_t distance);
+	static uint16_t squareRoot(uint32_t value);
+
+	// type = 0: "position" control (Straight line with parabolic blends)
+	// type = 1: "velocity" control (Straight line with parabolic blends)
+	uint8_t type;           // Target type
+
+	int32_t target;         // Target Position (Q16.16) or Velocity (Q8.24)
+	int32_t curPos;         // Current Position (Q16.16 units)
+	int32_t curVel;         // Current Velocity (Q8.24 units/tick)
+	uint8_t velCarry;       // Bits of the last velocity-mode step below one position unit (starts at half, to round)
+	int32_t velGoal;        // Velocity limit of the current move (Q8.24 units/tick)
+	int32_t maxVelStep;     // Maximum Velocity (Q8.24 units/tick)
+	int32_t accStep;        // Acceleration (Q8.24 units/tick^2)
+	int32_t decStep;        // Deceleration (Q8.24 units/tick^2)
+	uint32_t brakeFactor;   // Cached braking factor 2*dec, in the scale of the shifted speed squared
+	uint32_t brakeLimit;    // Shifted distance beyond which any speed can stop
+	uint16_t decShifted;    // Deceleration in the scale of the shifted speed
+	uint8_t speedShift;     // Right shift which makes the speed fit into 15 bits
+	uint8_t distanceShift;  // Right shift of the distance, so that the braking factor is an integer
+	int32_t posThreshold;   // Position error threshold (Q16.16 units)
+	uint32_t tickPeriod;    // Cached update period (microseconds)
+	unsigned long oldTime;  // Time at which the last tick was processed (microseconds)
+
+	float threshold;        // Error threshold below which no motion occurs
+	float maxVel;           // Maximum Velocity (units/second)
+	float acc;              // Constant Acceleraction (units/second^2)
+	float dec;              // Constant Deceleration (units/second^2)
+	uint16_t rate;          // Update rate (Hz)
+	bool noTasks;
+};
+
+
+/**
+ * Default constructor
+ *
+ * @param (_maxVel) Maximum velocity - default = 100
+ * @param (_acc) Constant acceleration - default = 50
+ * @param (_dec) Constant deceleration - default = same as acceleration
+ * @param (_thesh) Cutoff threshold - default = 0.1
+ * @param (_rate) Update rate in Hz - default = 100 (also used if 0)
+ */
+FixedTrajectory::FixedTrajectory(float _maxVel, float _acc, float _dec, float _thresh, uint16_t _rate) {
+	type = 0;
+	target = 0;
+	curPos = 0;
+	curVel = 0;
+	velCarry = 1 << (TRAJ_VEL_SHIFT - TRAJ_POS_SHIFT - 1);
+	maxVel = _maxVel;
+	acc = _acc;
+	if (_dec == -1) dec = _acc;
+	else dec = _dec;
+	threshold = _thresh;
+	rate = (_rate > 0)? _rate : 100;
+	updateSteps();
+	velGoal = maxVelStep;
+	oldTime = micros();
+	noTasks = true;
+}
+
+
+/**
+ * Default destructor
+ */
+FixedTrajectory::~FixedTrajectory() {
+	// Empty
+}
+
+
+/**
+ * Recalculate the cached per-tick constants
+ *
+ * @note This is called whenever the limits or the update rate change,
+ *       so that no divisions are required in the update function.
+ */
+void FixedTrajectory::updateSteps() {
+	float dT = 1.0 / rate;
+	maxVelStep = maxVel * dT * TRAJ_VEL_SCALE;
+	accStep = acc * dT * dT * TRAJ_VEL_SCALE;
+	decStep = dec * dT * dT * TRAJ_VEL_SCALE;
+	if (decStep < 1) decStep = 1;
+	posThreshold = threshold * TRAJ_POS_SCALE;
+	tickPeriod = 1000000UL / rate;
+
+	// The braking distance is calculated using 32-bit numbers: the speed is
+	// shifted right until the fastest possible speed and the deceleration fit
+	// into 15 bits, and the distance is multiplied by 2*dec in the scale of
+	// that speed squared. The shifted deceleration is rounded up, so that
+	// the result is always on the safe side of the real braking distance
+	uint32_t maxSpeed = (uint32_t) maxVelStep + accStep;
+	if ((uint32_t) decStep > maxSpeed) maxSpeed = decStep;
+	speedShift = 0;
+	while ((maxSpeed >> speedShift) > 0x7FFF) speedShift++;
+	decShifted = ((uint32_t) decStep + (1UL << speedShift) - 1) >> speedShift;
+
+	// The distance has 8 fewer fractional bits than the speed. If the speed
+	// is shifted by more than 4 bits, the factor is shifted right as well
+	// (rounding down, which is on the safe side), but the distance is shifted
+	// instead where needed so that the factor keeps at least 15 bits
+	int8_t factorShift = (TRAJ_VEL_SHIFT - TRAJ_POS_SHIFT) - 2 * speedShift;
+	distanceShift = 0;
+	while (factorShift < 0 && ((2UL * decStep) >> -factorShift) < 32768UL) {
+		factorShift++;
+		distanceShift++;
+	}
+
+	if (factorShift < 0) brakeFactor = (2UL * decStep) >> -factorShift;
+	else brakeFactor = (2UL * decStep) << factorShift;
+	brakeLimit = (4294967295UL - (uint32_t) decShifted * decShifted) / brakeFactor;
+}
+
+
+/**
+ * Change the update rate
+ *
+ * @param  (_rate) The update rate in Hz
+ * @return (True) if successful, (False) if the rate was 0 and was not changed
+ */
+bool FixedTrajectory::setRate(uint16_t _rate) {
+	if (_rate == 0) return false;
+	rate = _rate;
+	updateSteps();
+	return true;
+}
+
+
+/**
+ * Get the current target position or velocity
+ *
+ * @return The target position (units) or velocity (units/second)
+ */
+float FixedTrajectory::getTarget() {
+	if (type == 0) return target * (1.0 / TRAJ_POS_SCALE);
+	else return target * (rate / TRAJ_VEL_SCALE);
+}
+
+
+/**
+ * Set a new target position
+ *
+ * @param  (_targetPos) New target position value
+ * @note   This overides any previous position or velocity commands
+ */
+void FixedTrajectory::setTargetPos(float _targetPos) {
+	target = _targetPos * TRAJ_POS_SCALE;
+	velGoal = maxVelStep;
+	type = 0;
+	noTasks = false;
+}
+
+
+/**
+ * Set a new target position and time
+ *
+ * @param  (_targetPos) New target position value
+ * @param  (_time) The time in seconds until system should reach target position
+ * @return (True) goal is achievable, (False) goal won't be achieved within specified time
+ * @note   This overides any previous position or velocity commands
+ */
+bool FixedTrajectory::setTargetPos(float _targetPos, float _time) {
+	target = _targetPos * TRAJ_POS_SCALE;
+
+	// Current velocity in the direction of the target
+	float startVel = (_targetPos < getPos())? -getVel() : getVel();
+
+	// Calculate the velocity required to reach the goal within the specified time
+	float velocity = Trajectory::timedVelocity(abs(_targetPos - getPos()), _time, startVel, acc, dec);
+
+	// If no solution exists, move as fast as possible
+	if (velocity < 0 || velocity > maxVel) velocity = maxVel;
+
+	velGoal = velocity / rate * TRAJ_VEL_SCALE;
+	type = 0;
+	noTasks = false;
+
+	if (velocity == maxVel) return false;
+	else return true;
+}
+
+
+/**
+ * Set a new target velocity
+ *
+ * @param  (_targetVel) New target velocity value
+ * @note   This overides any previous position or velocity commands
+ */
+void FixedTrajectory::setTargetVel(float _targetVel) {
+	if (_targetVel > maxVel) target = maxVelStep;
+	else if (_targetVel < -maxVel) target = -maxVelStep;
+	else target = _targetVel / rate * TRAJ_VEL_SCALE;
+	type = 1;
+	noTasks = false;
+}
+
+
+/**
+ * Find the fastest speed which can still stop at the target after this tick
+ *
+ * @param  (distance) The distance to the target (Q16.16 units)
+ * @return The speed (Q8.24 units/tick), or 0x7FFFFFFF if there is no limit
+ * @note   The speed v solves v + v^2/(2*dec) = distance, where the time
+ *         step is one tick. Multiplying by 2*dec gives (v + dec)^2 =
+ *         2*dec*distance + dec^2, which is calculated with the speed
+ *         shifted down to 15 bits so that it fits into 32-bit numbers.
+ *         The result is rounded down, so the system never overshoots
+ */
+int32_t FixedTrajectory::stopSpeed(int32_t distance) {
+	if (distance <= 0) return 0;
+
+	// Beyond this distance, even the fastest speed can stop
+	uint32_t shiftedDistance = (uint32_t) distance >> distanceShift;
+	if (shiftedDistance > brakeLimit) return 0x7FFFFFFF;
+
+	uint32_t root = squareRoot(shiftedDistance * brakeFactor + (uint32_t) decShifted * decShifted);
+	return (int32_t) (root - decShifted) << speedShift;
+}
+
+
+/**
+ * Integer square root, rounded down
+ *
+ * @param  (value) The number
+ * @return The square root of the number
+ */
+uint16_t FixedTrajectory::squareRoot(uint32_t value) {
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > value) bit >>= 2;
+
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+
+/**
+ * Advance the controller by one tick
+ *
+ * @return  The new current position of the system (Q16.16)
+ * @note    This function is short enough to be called from a timer
+ *          interrupt running at the update rate set for the class
+ */
+int32_t FixedTrajectory::step() {
+
+	// Position Control (Linear velocity with parabolic blends)
+	if (type == 0) {
+
+		int32_t posError = target - curPos;
+		int32_t distance = (posError < 0)? -posError : posError;
+		int32_t absVel = (curVel < 0)? -curVel : curVel;
+
+		// If position error is above the threshold, or the system is
+		// moving too fast to stop within one tick (eg. target was changed)
+		if (distance > posThreshold || absVel > decStep) {
+
+			// Velocity in the direction of the target
+			int32_t speed = (posError < 0)? -curVel : curVel;
+			int32_t lastSpeed = speed;
+			bool limited = false;
+
+			if (speed < 0) {
+				// Moving away from the target, so turn around. The speed stops
+				// at zero, so it never changes faster than the deceleration
+				speed += decStep;
+				if (speed > 0) speed = 0;
+			} else {
+				// Accelerate up to the velocity limit, or slow down to the
+				// lower velocity limit of a new move
+				int32_t newSpeed = speed + accStep;
+				if (newSpeed > velGoal) newSpeed = (speed > velGoal)? max(speed - decStep, velGoal) : velGoal;
+
+				// Limit the speed so that the system can still stop at the target
+				int32_t limit = stopSpeed(distance);
+				if (newSpeed > limit) {
+					newSpeed = limit;
+					limited = true;
+				}
+
+				// The system can't slow down faster than the deceleration
+				if (newSpeed < speed - decStep) newSpeed = speed - decStep;
+				speed = newSpeed;
+			}
+
+			// Update the current velocity
+			curVel = (posError < 0)? -speed : speed;
+
+			// Position step, rounded towards zero so that the distance is never
+			// covered faster than the braking speed assumes. A speed which is
+			// below the position resolution still creeps towards the target
+			int32_t absStep = ((speed < 0)? -speed : speed) >> (TRAJ_VEL_SHIFT - TRAJ_POS_SHIFT);
+			if (absStep == 0 && speed > 0 && distance > 0) absStep = 1;
+
+			// Settle at the target if this tick reaches or passes it (or if the
+			// remaining distance is below the resolution of the braking speed),
+			// and the speed can be stopped within one tick. Otherwise the system
+			// is moving too fast, and overshoots before turning around
+			if (lastSpeed <= decStep && ((speed > 0 && absStep >= distance) || (limited && absStep == 0))) {
+				curVel = 0;
+				curPos = target;
+				noTasks = true;
+			} else {
+				curPos += (curVel < 0)? -absStep : absStep;
+			}
+
+		} else {
+			curVel = 0;
+			curPos = target;
+			noTasks = true;
+		}
+
+	// Velocity Control (Linear velocity with parabolic blends)
+	} else if (type == 1) {
+
+		int32_t velError = target - curVel;
+		int32_t absError = (velError < 0)? -velError : velError;
+
+		// Determine whether to accelerate or decelerate
+		int32_t acceleration = accStep;
+		if (target < curVel && curVel > 0) acceleration = -decStep;
+		else if (target < curVel && curVel <= 0) acceleration = -accStep;
+		else if (target > curVel && curVel < 0) acceleration = decStep;
+
+		// Update the current velocity. The target velocity is only reached
+		// once it is within one step, so the velocity never jumps to it
+		int32_t absStep = (acceleration < 0)? -acceleration : acceleration;
+		if (absStep < absError) curVel += acceleration;
+		else {
+			curVel = target;
+			noTasks = true;
+		}
+
+		// Limit Velocity
+		if (curVel > maxVelStep) curVel = maxVelStep;
+		else if (curVel < -maxVelStep) curVel = -maxVelStep;
+
+		// Update current position. The bits dropped by the shift are carried
+		// to the next tick, so that the position is rounded the same way for
+		// both directions instead of always towards minus infinity
+		int32_t posStep = curVel + velCarry;
+		curPos += posStep >> (TRAJ_VEL_SHIFT - TRAJ_POS_SHIFT);
+		velCarry = posStep & ((1 << (TRAJ_VEL_SHIFT - TRAJ_POS_SHIFT)) - 1);
+	}
+
+	return curPos;
+}
+
+
+/**
+ * Update the controller using the microsecond timer
+ *
+ * Runs one tick for every whole update period which has elapsed
+ * since the last call, so no time is lost between calls. After a
+ * long pause, at most TRAJ_MAX_TICKS ticks are run and the rest of
+ * the time is skipped, so that the function always returns quickly.
+ *
+ * @return  The new current position of the system
+ */
+float FixedTrajectory::update() {
+	unsigned long newTime = micros();
+	if (newTime - oldTime > TRAJ_MAX_TICKS * tickPeriod) {
+		oldTime = newTime - TRAJ_MAX_TICKS * tickPeriod;
+	}
+
+	while (newTime - oldTime >= tickPeriod) {
+		oldTime += tickPeriod;
+		step();
+	}
+	return getPos();
+}
+
+
+/**
+ * Reset all class variables
+ *
+ * @param (newPos) the current position - default = 0
+ */
+void FixedTrajectory::reset(float newPos) {
+	curPos = newPos * TRAJ_POS_SCALE;
+	curVel = 0;
+	velCarry = 1 << (TRAJ_VEL_SHIFT - TRAJ_POS_SHIFT - 1);
+	target = 0;
+	velGoal = maxVelStep;
+	noTasks = true;
+	oldTime = micros();
+}
+
+
+/**
+ * Set/reset the current position value
+ *
+ * @param (newPos) the new current position - default = 0
+ */
+void FixedTrajectory::setPos(float newPos) {
+	curPos = newPos * TRAJ_POS_SCALE;
+	velCarry = 1 << (TRAJ_VEL_SHIFT - TRAJ_POS_SHIFT - 1);
+}
+
+
+#endif /* TRAJECTORY_FIXED_H */
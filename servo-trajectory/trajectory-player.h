@@ -0,0 +1,153 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * TRAJECTORY TABLE PLAYER CLASSES
+ *
+ * Code by: Simon Bluett
+ * Website: https://wired.chillibasket.com
+ * Version: 1.0
+ * Date:    18th October 2026
+ * Copyright (C) 2026, MIT License
+ *
+ * These classes replay a motion which was previously rendered
+ * into a table using the "render()" or "renderDelta()" functions
+ * of the Trajectory class. Each call to "next()" only requires
+ * one array load, so the classes can be used inside a timer
+ * interrupt to play back the motion at a precise rate.
+ *
+ * TrajectoryPlayer<T>    Plays a table of positions (float/int16_t)
+ * DeltaTrajectoryPlayer  Plays a table of 8-bit position changes
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef TRAJECTORY_PLAYER_H
+#define TRAJECTORY_PLAYER_H
+
+#include <Arduino.h>
+
+
+/**
+ * Position Table Player Class Definition
+ */
+template<class T>
+class TrajectoryPlayer {
+
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param  (buffer) Pointer to the table of positions
+	 * @param  (length) The number of samples in the table
+	 */
+	TrajectoryPlayer(const T *buffer, uint16_t length) {
+		table = buffer;
+		tableLength = length;
+		restart();
+	};
+
+	// Get the next position from the table
+	T next();
+
+	// Restart playback from the beginning of the table
+	void restart();
+
+	/**
+	 * Check if all samples have been played
+	 */
+	bool finished() { return done; };
+
+private:
+	const T *table;
+	uint16_t tableLength;
+	uint16_t index;
+	volatile bool done;
+};
+
+
+/**
+ * Get the next position from the table
+ *
+ * @return The next position, or the final position once the table is finished
+ *         (or 0 if the table is empty)
+ */
+template<class T> T TrajectoryPlayer<T>::next() {
+	if (tableLength == 0) return 0;
+
+	T value = table[index];
+	if (index + 1 < tableLength) index++;
+	else done = true;
+	return value;
+}
+
+
+/**
+ * Restart playback from the beginning of the table
+ */
+template<class T> void TrajectoryPlayer<T>::restart() {
+	index = 0;
+	done = (tableLength == 0);
+}
+
+
+
+/**
+ * Position Change (Delta) Table Player Class Definition
+ */
+class DeltaTrajectoryPlayer {
+
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param  (buffer) Pointer to the table of position changes
+	 * @param  (length) The number of samples in the table
+	 * @param  (startPos) The start position returned by "renderDelta()"
+	 */
+	DeltaTrajectoryPlayer(const int8_t *buffer, uint16_t length, int16_t startPos) {
+		table = buffer;
+		tableLength = length;
+		startPosition = startPos;
+		restart();
+	};
+
+	// Get the next position from the table
+	int16_t next();
+
+	// Restart playback from the beginning of the table
+	void restart();
+
+	/**
+	 * Check if all samples have been played
+	 */
+	bool finished() { return done; };
+
+private:
+	const int8_t *table;
+	uint16_t tableLength;
+	uint16_t index;
+	int16_t startPosition;
+	int16_t position;
+	volatile bool done;
+};
+
+
+/**
+ * Get the next position from the table
+ *
+ * @return The next position, or the final position once the table is finished
+ */
+int16_t DeltaTrajectoryPlayer::next() {
+	if (index < tableLength) position += table[index++];
+	if (index >= tableLength) done = true;
+	return position;
+}
+
+
+/**
+ * Restart playback from the beginning of the table
+ */
+void DeltaTrajectoryPlayer::restart() {
+	index = 0;
+	position = startPosition;
+	done = (tableLength == 0);
+}
+
+
+#endif /* TRAJECTORY_PLAYER_H */
@@ -0,0 +1,106 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * MOTION TABLE EXAMPLE SKETCH FOR THE SERVO TRAJECTORY CONTROLLER
+ *
+ * Code by: Simon Bluett
+ * Website: https://wired.chillibasket.com
+ * Version: 1.0
+ * Date:    18th October 2026
+ * Copyright (C) 2026, MIT License
+ *
+ * For moves which are repeated many times, the whole motion
+ * can be calculated once and saved into a table. Playing back
+ * the table then only requires one array load per update,
+ * which is fast enough to be done inside a timer interrupt.
+ *
+ * In this example, the move from 20° to 180° and back is
+ * rendered into two tables of 8-bit position changes, with
+ * a resolution of 0.1°. The tables are then played back
+ * continuously at a rate of 100Hz.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+
+// --- Include the libraries ---
+// Make sure that "trajectory.h" and "trajectory-player.h" are
+// included in the same folder as the Arduino sketch
+#include "trajectory.h"
+#include "trajectory-player.h"
+#include <Servo.h>
+
+
+// --- Define global variables ---
+#define UPDATE_FREQUENCY 100
+#define UPDATE_TIME (1000 / UPDATE_FREQUENCY)
+#define TABLE_LENGTH 450
+#define TABLE_SCALE 10
+
+Trajectory servoTrajectory(60, 40, 34);
+Servo myservo;
+
+// Tables containing the position changes of each move
+int8_t forwardTable[TABLE_LENGTH];
+int8_t reverseTable[TABLE_LENGTH];
+DeltaTrajectoryPlayer *players[2];
+uint8_t currentMove = 0;
+
+unsigned long updateTimer = 0;
+
+
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * SETUP
+ * * * * * * * * * * * * * * * * * * * * * * */
+void setup() {
+
+	Serial.begin(115200);
+	while(!Serial);
+	Serial.println("Starting program");
+
+	myservo.attach(9);
+	myservo.write(20);
+
+	// Render the move from 20° to 180°
+	int16_t forwardStart, reverseStart;
+	servoTrajectory.reset(20);
+	servoTrajectory.setTargetPos(180);
+	uint16_t forwardLength = servoTrajectory.renderDelta(forwardTable, TABLE_LENGTH, UPDATE_TIME, forwardStart, TABLE_SCALE);
+
+	// Render the move from 180° back to 20°
+	servoTrajectory.setTargetPos(20);
+	uint16_t reverseLength = servoTrajectory.renderDelta(reverseTable, TABLE_LENGTH, UPDATE_TIME, reverseStart, TABLE_SCALE);
+
+	Serial.print("Forward samples: "); Serial.println(forwardLength);
+	Serial.print("Reverse samples: "); Serial.println(reverseLength);
+
+	// Set up a player for each of the tables
+	static DeltaTrajectoryPlayer forwardPlayer(forwardTable, forwardLength, forwardStart);
+	static DeltaTrajectoryPlayer reversePlayer(reverseTable, reverseLength, reverseStart);
+	players[0] = &forwardPlayer;
+	players[1] = &reversePlayer;
+
+	updateTimer = millis();
+}
+
+
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * LOOP
+ * * * * * * * * * * * * * * * * * * * * * * */
+void loop() {
+
+	// Play back the tables at regular intervals; this could
+	// also be done inside a timer interrupt (see "setupTimers.h")
+	if (millis() - updateTimer >= UPDATE_TIME) {
+		updateTimer += UPDATE_TIME;
+
+		// Get the next angle from the table (in units of 0.1°)
+		int16_t angle = players[currentMove]->next();
+		myservo.write((angle + TABLE_SCALE / 2) / TABLE_SCALE);
+
+		Serial.print("Angle: ");
+		Serial.println(angle / float(TABLE_SCALE));
+
+		// Once a move has finished, start playing the other table
+		if (players[currentMove]->finished()) {
+			currentMove = !currentMove;
+			players[currentMove]->restart();
+		}
+	}
+}
@@ -0,0 +1,89 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * MINIMAL ARDUINO STAND-IN FOR COMPILING ON A PC
+ *
+ * Code by: Simon Bluett
+ * Website: https://wired.chillibasket.com
+ * Version: 1.1
+ * Date:    18th October 2026
+ * Copyright (C) 2026, MIT License
+ *
+ * Provides just enough of the Arduino functions to compile
+ * the trajectory classes and the verification sketch with a
+ * normal C++ compiler (see "trajectory-verify-host.cpp").
+ *
+ * The "millis()" clock is simulated: it only advances when
+ * "delay()" or "delayMicroseconds()" is called, so the moves
+ * do not depend on the speed of the PC. "micros()" uses the
+ * real clock, so that the time per update can be measured.
+ * "analogRead()" returns the seed given on the command line,
+ * so that "randomSeed(analogRead(0))" selects the test run.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ARDUINO_HOST_H
+#define ARDUINO_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using std::abs;
+using std::pow;
+using std::sqrt;
+using std::round;
+
+#define max(a,b) ((a)>(b)?(a):(b))
+#define min(a,b) ((a)<(b)?(a):(b))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+
+// --- Simulated clock for millis(), real clock for micros() ---
+static unsigned long hostMicros = 0;
+static const std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+inline unsigned long micros() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+inline unsigned long millis() { return hostMicros / 1000; }
+inline void delayMicroseconds(unsigned int us) { hostMicros += us; }
+inline void delay(unsigned long ms) { hostMicros += ms * 1000; }
+
+
+// --- Random numbers ---
+static unsigned long hostSeed = 0;
+static std::mt19937 hostRandom;
+
+inline int analogRead(uint8_t pin) { (void) pin; return hostSeed; }
+inline void randomSeed(unsigned long seed) { hostRandom.seed(seed); }
+inline long random(long maxValue) { return (maxValue > 0)? hostRandom() % maxValue : 0; }
+inline long random(long minValue, long maxValue) { return minValue + random(maxValue - minValue); }
+
+
+// --- Serial output to the console ---
+class HostSerial {
+public:
+	void begin(unsigned long baud) { (void) baud; }
+	operator bool() { return true; }
+
+	void print(const char *text) { fputs(text, stdout); }
+	void print(char value) { putchar(value); }
+	void print(int value) { printf("%d", value); }
+	void print(long value) { printf("%ld", value); }
+	void print(unsigned int value) { printf("%u", value); }
+	void print(unsigned long value) { printf("%lu", value); }
+	void print(double value, int digits = 2) { printf("%.*f", digits, value); }
+
+	void println() { putchar('\n'); }
+	template <class T> void println(T value) { print(value); println(); }
+	void println(double value, int digits) { print(value, digits); println(); }
+};
+
+static HostSerial Serial;
+
+#endif /* ARDUINO_HOST_H */
@@ -0,0 +1,36 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * PC WRAPPER FOR THE TRAJECTORY VERIFICATION SKETCH
+ *
+ * Code by: Simon Bluett
+ * Website: https://wired.chillibasket.com
+ * Version: 1.1
+ * Date:    18th October 2026
+ * Copyright (C) 2026, MIT License
+ *
+ * Compiles "trajectory-verify.ino" as a normal program, so
+ * that millions of random moves can be checked in a few
+ * minutes. Compile and run from this folder:
+ *
+ *   g++ -O2 -I. trajectory-verify-host.cpp -o trajectory-verify
+ *   ./trajectory-verify [moves per mode] [seed]
+ *
+ * The output is the same CSV as on the Arduino. The time per
+ * update is measured with the real clock of the PC.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "Arduino.h"
+
+// Number of moves is read from the command line
+static long hostMoves = 1000;
+#define NUMBER_OF_MOVES hostMoves
+
+#include "../trajectory-verify.ino"
+
+
+int main(int argc, char *argv[]) {
+	if (argc > 1) hostMoves = atol(argv[1]);
+	if (argc > 2) hostSeed = strtoul(argv[2], NULL, 10);
+
+	setup();
+	return 0;
+}
@@ -0,0 +1,341 @@
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * VERIFICATION SKETCH FOR THE SERVO TRAJECTORY CONTROLLER CLASS
+ *
+ * Code by: Simon Bluett
+ * Website: https://wired.chillibasket.com
+ * Version: 1.2
+ * Date:    18th October 2026
+ * Copyright (C) 2026, MIT License
+ *
+ * This sketch checks that the Trajectory class keeps to its
+ * limits, by running a large number of random moves. Instead
+ * of waiting for the real clock, each move is simulated by
+ * calling "update(dT)" with a random amount of timing jitter.
+ * The limits, the position threshold and the average update
+ * time are chosen randomly for every move. In the "retarget"
+ * mode, a new target (which may be behind the system, so that
+ * it has to turn around) is set while the system is moving,
+ * sometimes with a new velocity limit or a time of arrival.
+ *
+ * For every update, the following constraints are checked:
+ * 1. The velocity never exceeds the maximum velocity, apart
+ *    from slowing down after the limit was lowered
+ * 2. The velocity never changes by more than the acceleration
+ *    (when speeding up) or the deceleration (when slowing down
+ *    or turning around) allows, including the final update
+ * 3. Moves never overshoot the target by more than the position
+ *    threshold, apart from the distance needed to stop when the
+ *    target was changed while moving
+ * 4. Every move finishes within a bounded number of updates
+ * 5. Moves with a specified time arrive at the requested time
+ *
+ * The results are printed over Serial as CSV, so they can be
+ * saved and compared after changes to the class:
+ * - Summary: mode, moves, updates, violations, stuck moves, worst arrival error (s), time per update (ns)
+ *   The time per update does not include the time taken by "micros()" itself
+ * - Profile: time (s), position, velocity, acceleration of one example move
+ *
+ * @note The folder "trajectory-verify-host" contains a wrapper
+ *       to compile this sketch on a PC, which is much faster
+ *       when running millions of moves.
+ * * * * * * * * * * * * * * * * * * * * * * */
+
+
+// --- Include the library ---
+// Make sure that the file "trajectory.h" is included in
+// the same folder as the Arduino sketch
+#include "trajectory.h"
+
+
+// --- Test settings ---
+#ifndef NUMBER_OF_MOVES
+#define NUMBER_OF_MOVES 1000   // Number of random moves for each mode
+#endif
+#define MIN_UPDATE_TIME 1      // Shortest average time between updates (ms)
+#define MAX_UPDATE_TIME 50     // Longest average time between updates (ms)
+#define UPDATE_JITTER   0.2    // Maximum random timing jitter (fraction of the update time)
+#define ARRIVAL_UPDATES 15     // Allowed arrival time error (number of updates)
+#define TOLERANCE       0.001  // Allowed numerical error (fraction of the limit)
+#define RETARGET_TIME   2      // Latest time at which the target is changed in the retarget mode (s)
+#define MIN_THRESHOLD   0.001  // Smallest position threshold of the controller
+#define MAX_THRESHOLD   0.1    // Largest position threshold of the controller
+#define PROFILE_TIME    10     // Time between updates of the example profile (ms)
+
+enum test_mode_t {
+	mode_position = 0,
+	mode_timed = 1,
+	mode_velocity = 2,
+	mode_retarget = 3
+};
+
+const char *modeNames[] = {"position", "timed", "velocity", "retarget"};
+
+
+/**
+ * Get a random number within a range
+ *
+ * @param  (minValue) Minimum value
+ * @param  (maxValue) Maximum value
+ * @return The random number
+ */
+float randomFloat(float minValue, float maxValue) {
+	return minValue + (maxValue - minValue) * (random(0, 10001) / 10000.0);
+}
+
+
+/**
+ * Get the longest time a move should take, after which it is stuck
+ *
+ * A move is stuck if it takes twice as long as expected, so that
+ * the number of updates is bounded even for the shortest updates
+ *
+ * @param  (distance) Distance to the target, or 0 in velocity mode
+ * @param  (moveTime) Requested time of the move (s), or 0 if not timed
+ * @param  (speed) Speed when the move is started
+ * @param  (maxVel) Maximum velocity
+ * @param  (acc) Acceleration
+ * @param  (dec) Deceleration
+ * @return The time limit (s)
+ */
+float moveTimeout(float distance, float moveTime, float speed, float maxVel, float acc, float dec) {
+	// If moving away from the target, the system first needs to stop and come back
+	float stopDistance = speed * speed / (2 * dec);
+	return 2 * (moveTime + maxVel / acc + (maxVel + speed) / dec + (distance + 2 * stopDistance) / maxVel) + 1;
+}
+
+
+/**
+ * Measure the time taken by the stopwatch itself, so that it can
+ * be subtracted from the time per update
+ *
+ * @return The average time of one measurement (ns)
+ */
+float stopwatchOverhead() {
+	unsigned long totalTime = 0;
+
+	for (int i = 0; i < 10000; i++) {
+		unsigned long stopwatch = micros();
+		totalTime += micros() - stopwatch;
+	}
+
+	return totalTime * 1000.0 / 10000;
+}
+
+
+/**
+ * Run random moves in one of the control modes and check the constraints
+ *
+ * @param  (mode) The control mode to be tested
+ * @param  (overhead) Time taken by the stopwatch (ns)
+ */
+void verifyMode(enum test_mode_t mode, float overhead) {
+	unsigned long totalUpdates = 0;
+	unsigned long violations = 0;
+	unsigned long stuck = 0;
+	unsigned long updateTime = 0;
+	float worstArrival = 0;
+
+	for (long i = 0; i < NUMBER_OF_MOVES; i++) {
+
+		// Random limits and move
+		float maxVel = randomFloat(1, 500);
+		float acc = randomFloat(1, 1000);
+		float dec = randomFloat(1, 1000);
+		float start = randomFloat(-1000, 1000);
+		float target = randomFloat(-1000, 1000);
+		float moveTime = 0;
+
+		// Random threshold (evenly spread on a log scale) and update time
+		float threshold = MIN_THRESHOLD * pow(MAX_THRESHOLD / MIN_THRESHOLD, randomFloat(0, 1));
+		float updatePeriod = randomFloat(MIN_UPDATE_TIME, MAX_UPDATE_TIME);
+
+		Trajectory trajectory(maxVel, acc, dec, threshold);
+		trajectory.reset(start);
+
+		bool timed = false;
+		if (mode == mode_position || mode == mode_retarget) {
+			trajectory.setTargetPos(target);
+		} else if (mode == mode_timed) {
+			moveTime = randomFloat(0.5, 30);
+			timed = trajectory.setTargetPos(target, moveTime);
+		} else {
+			target = randomFloat(-maxVel, maxVel);
+			trajectory.setTargetVel(target);
+		}
+
+		// 4. Bound the number of updates of the move
+		float timeout = moveTimeout((mode == mode_velocity)? 0 : abs(target - start), moveTime, 0, maxVel, acc, dec);
+		unsigned long maxUpdates = timeout * 1000 / (updatePeriod * (1 - UPDATE_JITTER)) + 1;
+
+		// 3. Range of positions which may be reached, without the threshold
+		float lowPos = min(start, target);
+		float highPos = max(start, target);
+
+		// Time at which the target is changed (if at all)
+		float retargetTime = (mode == mode_retarget)? randomFloat(0, RETARGET_TIME) : -1;
+		float moveStart = start;
+		float moveSpeed = 0;
+		float moveElapsed = 0;
+		bool aboveLimit = false;
+
+		float lastVel = 0;
+		float elapsed = 0;
+		unsigned long updates = 0;
+
+		while (updates < maxUpdates) {
+
+			// Change the target while moving; sometimes with a new velocity
+			// limit, or with a time of arrival
+			if (retargetTime >= 0 && elapsed >= retargetTime) {
+				retargetTime = -1;
+				moveStart = trajectory.getPos();
+				moveElapsed = elapsed;
+				target = randomFloat(-1000, 1000);
+				moveSpeed = (target >= moveStart)? lastVel : -lastVel;
+
+				long option = random(0, 3);
+				if (option == 1) {
+					maxVel = randomFloat(1, 500);
+					trajectory.setMaxVel(maxVel);
+					aboveLimit = abs(lastVel) > maxVel;
+				}
+
+				if (option == 2) {
+					moveTime = randomFloat(0.5, 30);
+					timed = trajectory.setTargetPos(target, moveTime);
+				} else {
+					moveTime = 0;
+					trajectory.setTargetPos(target);
+				}
+
+				// The system may need to pass the target or turn around, but never moves
+				// further than its stopping distance (plus one update) in the old direction
+				float stopPos = moveStart + lastVel * abs(lastVel) / (2 * dec);
+				float margin = abs(lastVel) * updatePeriod * (1 + UPDATE_JITTER) / 1000.0;
+				lowPos = min(min(moveStart, target), stopPos - margin);
+				highPos = max(max(moveStart, target), stopPos + margin);
+
+				timeout = moveTimeout(abs(target - moveStart), moveTime, abs(lastVel), maxVel, acc, dec);
+				maxUpdates = updates + timeout * 1000 / (updatePeriod * (1 - UPDATE_JITTER)) + 1;
+			}
+
+			if (trajectory.ready()) break;
+
+			float dT = updatePeriod * (1 + randomFloat(-UPDATE_JITTER, UPDATE_JITTER));
+
+			unsigned long stopwatch = micros();
+			trajectory.update(dT);
+			updateTime += micros() - stopwatch;
+
+			elapsed += dT / 1000.0;
+			updates++;
+
+			float pos = trajectory.getPos();
+			float vel = trajectory.getVel();
+
+			// 1. Velocity limit; after the limit was lowered, the system
+			//    may be above it while slowing down
+			if (abs(vel) > maxVel * (1 + TOLERANCE)) {
+				if (!aboveLimit || abs(vel) >= abs(lastVel)) violations++;
+			} else {
+				aboveLimit = false;
+			}
+
+			// 2. Acceleration limit of the current phase of the motion, allowing
+			//    for the rounding error of the float velocity
+			bool speedingUp = abs(vel) > abs(lastVel) && vel * lastVel >= 0;
+			float maxChange = ((speedingUp)? acc : dec) * dT / 1000.0;
+			if (abs(vel - lastVel) > maxChange * (1 + TOLERANCE) + abs(vel) * 1e-6 + 1e-5) violations++;
+			lastVel = vel;
+
+			// 3. No overshoot (beyond the threshold)
+			if (mode != mode_velocity) {
+				if (pos < lowPos - threshold || pos > highPos + threshold) violations++;
+			}
+		}
+
+		if (!trajectory.ready()) {
+			stuck++;
+			violations++;
+		}
+
+		// 5. Arrival time, allowing for a few updates of discretisation error plus
+		//    the time saved by stopping within the threshold of the target. This is
+		//    at most the threshold divided by the slowest cruise velocity, which is
+		//    (distance - stopping distance) / time. Very short moves are skipped,
+		//    as their duration depends mostly on the threshold
+		float cruiseDistance = abs(target - moveStart);
+		if (moveSpeed > 0) cruiseDistance -= moveSpeed * moveSpeed / (2 * dec);
+		if (timed && cruiseDistance > 10 * threshold) {
+			float arrivalError = abs(elapsed - moveElapsed - moveTime);
+			float allowedError = ARRIVAL_UPDATES * updatePeriod * (1 + UPDATE_JITTER) / 1000.0;
+			allowedError += threshold * moveTime / cruiseDistance;
+			if (arrivalError > worstArrival) worstArrival = arrivalError;
+			if (arrivalError > allowedError) violations++;
+		}
+
+		totalUpdates += updates;
+	}
+
+	// Output the results as CSV
+	Serial.print(modeNames[mode]); Serial.print(",");
+	Serial.print(NUMBER_OF_MOVES); Serial.print(",");
+	Serial.print(totalUpdates); Serial.print(",");
+	Serial.print(violations); Serial.print(",");
+	Serial.print(stuck); Serial.print(",");
+	Serial.print(worstArrival, 4); Serial.print(",");
+	Serial.println(max(updateTime * 1000.0 / max(totalUpdates, 1UL) - overhead, 0.0), 0);
+}
+
+
+/**
+ * Output the profile of one move, so that it can be plotted
+ */
+void printProfile() {
+	Trajectory trajectory(60, 40, 34);
+	trajectory.reset(20);
+	trajectory.setTargetPos(180);
+
+	Serial.println("time,position,velocity,acceleration");
+
+	float elapsed = 0;
+	while (!trajectory.ready()) {
+		trajectory.update(PROFILE_TIME);
+		elapsed += PROFILE_TIME / 1000.0;
+
+		TrajectorySetpoint setpoint = trajectory.getSetpoint();
+		Serial.print(elapsed, 3); Serial.print(",");
+		Serial.print(setpoint.pos, 4); Serial.print(",");
+		Serial.print(setpoint.vel, 4); Serial.print(",");
+		Serial.println(setpoint.acc, 4);
+	}
+}
+
+
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * SETUP
+ * * * * * * * * * * * * * * * * * * * * * * */
+void setup() {
+
+	Serial.begin(115200);
+	while(!Serial);
+	randomSeed(analogRead(0));
+
+	Serial.println("mode,moves,updates,violations,stuck,worst_arrival_s,ns_per_update");
+	float overhead = stopwatchOverhead();
+	verifyMode(mode_position, overhead);
+	verifyMode(mode_timed, overhead);
+	verifyMode(mode_velocity, overhead);
+	verifyMode(mode_retarget, overhead);
+
+	Serial.println();
+	printProfile();
+}
+
+
+/* * * * * * * * * * * * * * * * * * * * * * *
+ * LOOP
+ * * * * * * * * * * * * * * * * * * * * * * */
+void loop() {
+	// Empty
+}
@@ -27,6 +27,14 @@
 
 #include <Arduino.h>
 
+// Setpoint output, for example to use as feedforward terms of a PID controller
+struct TrajectorySetpoint {
+	float pos;         // Position (units)
+	float vel;         // Velocity (units/second)
+	float acc;         // Acceleration (units/second^2)
+};
+
+
 // TRAJECTORY CLASS
 class Trajectory {
 
@@ -45,16 +53,20 @@ public:
 	// Set max velocity, acceleration or decelleration
 	void setMaxVel(float _maxVel) { maxVel = _maxVel; };
 	void setAcc(float _acc) { acc = _acc; };
-	void setDec(float _dec) { dec = _dec; };
+	void setDec(float _dec) { dec = _dec; updateDec(); };
 
 	// Get the current max velocity, accel or decel values 
 	float getMaxVel() { return maxVel; };
 	float getAcc() { return acc; };
 	float getDec() { return dec; };
 
-	// Get the current position and velocity
+	// Get the current position, velocity and commanded acceleration
 	float getPos() { return curPos; };
 	float getVel() { return curVel; };
+	float getCurAcc() { return curAcc; };
+
+	// Get the position, velocity and acceleration all at once
+	TrajectorySetpoint getSetpoint() { return {curPos, curVel, curAcc}; };
 
 	// Set the current position
 	void setPos(float newPos = 0);
@@ -70,10 +82,21 @@ public:
 	float update(float dT);
 	float update();
 
+	// Render the motion into a buffer, calling update(dT) once per sample
+	uint16_t render(float *posBuffer, uint16_t length, float dT, float *velBuffer = NULL);
+	uint16_t render(int16_t *posBuffer, uint16_t length, float dT, float scale = 1);
+	uint16_t renderDelta(int8_t *deltaBuffer, uint16_t length, float dT, int16_t &startPos, float scale = 1);
+
+	// Calculate the cruise velocity required to complete a move in a set time
+	static float timedVelocity(float distance, float time, float startVel, float _acc, float _dec);
+
 	// Default destructor
 	~Trajectory(); 
 
 private:
+	void updateDec();
+	void movePos(float dP);
+
 	// type = 0: "position" control (Straight line with parabolic blends)
 	// type = 1: "velocity" control (Straight line with parabolic blends)
 	int type;          // Target type
@@ -81,11 +104,15 @@ private:
 	float threshold;   // Position error threshold below which no motion occurs 
 	float target;      // Target Position or Velocity
 	float curPos;      // Current Position (units)
+	float posCarry;    // Rounding error of the last position update (units)
 	float curVel;      // Current Velocity (units/second)
+	float curAcc;      // Current commanded Acceleration (units/second^2)
 	float maxVel;      // Maximum Velocity (units/second)
 	float velGoal;     // Target velocity to reach goal position at a specific time
+	float arrivalTime; // Time left until the goal position should be reached (seconds, < 0 if not timed)
 	float acc;         // Constant Acceleraction (units/second^2)
 	float dec;         // Constant Deceleration (units/second^2)
+	float halfInvDec;  // Cached value of 1/(2*dec), updated whenever dec is set
 	unsigned long oldTime;
 	bool noTasks;
 };
@@ -103,14 +130,18 @@ Trajectory::Trajectory(float _maxVel, float _acc, float _dec, float _thresh) {
 	type = 0;
 	target = 0;
 	curPos = 0;
+	posCarry = 0;
 	curVel = 0;
+	curAcc = 0;
 	maxVel = _maxVel;
 	velGoal = _maxVel;
+	arrivalTime = -1;
 	acc = _acc;
 	if (_dec == -1) dec = _acc;
 	else dec = _dec;
 	oldTime = millis();
 	threshold = _thresh;
+	updateDec();
 	noTasks = true;
 }
 
@@ -123,6 +154,14 @@ Trajectory::~Trajectory() {
 }
 
 
+/**
+ * Update the cached values which depend on the deceleration
+ */
+void Trajectory::updateDec() {
+	halfInvDec = 0.5 / dec;
+}
+
+
 /**
  * Set a new target position
  *
@@ -132,6 +171,7 @@ Trajectory::~Trajectory() {
 void Trajectory::setTargetPos(float _targetPos) {
 	target = _targetPos;
 	velGoal = maxVel;
+	arrivalTime = -1;
 	type = 0;
 	noTasks = false;
 }
@@ -147,21 +187,17 @@ void Trajectory::setTargetPos(float _targetPos) {
  */
 bool Trajectory::setTargetPos(float _targetPos, float _time) {
 	target = _targetPos;
-	
-	// Take into account the cut-off theshold
-	_time = _time + sqrt(2 * threshold / dec);
 
-	// Calculate the velocity required to reach the goal within the specified time
-	float sqrtTerm = (_time * _time) - 2 * abs(_targetPos - curPos) * (1/acc + 1/dec);
+	// Current velocity in the direction of the target
+	float startVel = (_targetPos < curPos)? -curVel : curVel;
 
-	// If the term is a positive number, then a solution exists
-	if (sqrtTerm >= 0) {
-		velGoal = (_time - sqrt(sqrtTerm)) / (1/acc + 1/dec);
+	// Calculate the velocity required to reach the goal within the specified time
+	float velocity = timedVelocity(abs(_targetPos - curPos), _time, startVel, acc, dec);
 
-		if (velGoal > maxVel) velGoal = maxVel;
-	} else {
-		velGoal = maxVel;
-	}
+	// If no solution exists, move as fast as possible
+	if (velocity < 0 || velocity > maxVel) velGoal = maxVel;
+	else velGoal = velocity;
+	arrivalTime = _time;
 
 	type = 0;
 	noTasks = false;
@@ -171,6 +207,61 @@ bool Trajectory::setTargetPos(float _targetPos, float _time) {
 }
 
 
+/**
+ * Calculate the cruise velocity required to complete a move in a set time
+ *
+ * The move starts at the current velocity, accelerates or decelerates
+ * to the cruise velocity, and then decelerates to a stop at the target.
+ * This only takes a fixed number of operations, so it is fast enough
+ * to be used when the target is updated on every control cycle.
+ *
+ * @param  (distance) The distance to the target position
+ * @param  (time) The time in seconds until system should reach target position
+ * @param  (startVel) The current velocity in the direction of the target
+ * @param  (_acc) Constant acceleration
+ * @param  (_dec) Constant deceleration
+ * @return The cruise velocity, or -1 if the move can't be done in the specified time
+ */
+float Trajectory::timedVelocity(float distance, float time, float startVel, float _acc, float _dec) {
+
+	// If moving away from the target, first include the time and distance needed to stop
+	if (startVel < 0) {
+		time += startVel / _dec;
+		distance += startVel * startVel / (2 * _dec);
+		startVel = 0;
+	}
+
+	if (time <= 0) return -1;
+
+	// Accelerate up to the cruise velocity, which is the solution of:
+	// (1/acc + 1/dec)/2 * v^2 - (time + v0/acc) * v + (distance + v0^2/(2*acc)) = 0
+	float invAccDec = 1 / _acc + 1 / _dec;
+	float linearTerm = time + startVel / _acc;
+	float constTerm = distance + startVel * startVel / (2 * _acc);
+	float sqrtTerm = linearTerm * linearTerm - 2 * invAccDec * constTerm;
+
+	// If the term is a positive number, then a solution exists. The smaller
+	// root is calculated in a form which avoids the rounding error of
+	// (linearTerm - sqrt(sqrtTerm)) for long and slow moves
+	if (sqrtTerm >= 0) {
+		float velocity = 2 * constTerm / (linearTerm + sqrt(sqrtTerm));
+		if (velocity >= startVel) return velocity;
+	}
+
+	// Otherwise decelerate down to the cruise velocity, which is the solution of:
+	// distance = v0^2/(2*dec) + v * (time - v0/dec)
+	// If the first solution was just below the start velocity, rounding errors can
+	// put this one just above it, so it is limited to the start velocity
+	float cruiseTime = time - startVel / _dec;
+	if (cruiseTime > 0) {
+		float velocity = (distance - startVel * startVel / (2 * _dec)) / cruiseTime;
+		if (velocity >= 0 && (velocity <= startVel || sqrtTerm >= 0)) return min(velocity, startVel);
+	}
+
+	return -1;
+}
+
+
 /**
  * Set a new target velocity
  *
@@ -181,6 +272,7 @@ void Trajectory::setTargetVel(float _targetVel) {
 	if (_targetVel > maxVel) target = maxVel;
 	else if (_targetVel < -maxVel) target = -maxVel;
 	else target = _targetVel;
+	arrivalTime = -1;
 	type = 1;
 	noTasks = false;
 }
@@ -195,47 +287,87 @@ void Trajectory::setTargetVel(float _targetVel) {
 float Trajectory::update(float dT) {
 
 	// Convert ms to seconds
-	dT /= 1000.0;
+	dT *= 0.001;
+
+	// Velocity before this update, to calculate the acceleration
+	float lastVel = curVel;
 
 	// Position Control (Linear velocity with parabolic blends)
 	if (type == 0) {
 
 		float posError = target - curPos;
-
-		// If position error is above the threshold
-		if (abs(posError) > threshold) {
-
-			// Determine motion direction
-			bool dir = true;
-			if (posError < 0) dir = false;
-
-			// Determine whether to accelerate or decelerate
-			float acceleration = acc;
-			if ((curVel * curVel / (2 * dec)) >= abs(posError)) acceleration = -dec;
+		float distance = abs(posError);
+
+		// Speed which can be stopped within this update
+		float stopStep = dec * dT;
+
+		// If position error is above the threshold, or the system is
+		// moving too fast to stop within one update (eg. target was changed)
+		if (distance > threshold || abs(curVel) > stopStep) {
+
+			// Determine motion direction and the velocity towards the target
+			float dir = (posError < 0)? -1 : 1;
+			float speed = curVel * dir;
+			float lastSpeed = speed;
+
+			// Timed moves are solved again on every update, so that the error of
+			// the discrete updates does not add up (eg. after slowing down from
+			// a fast move to a slow cruise velocity). Once the time is up, the
+			// rest of the move is done as fast as possible
+			if (arrivalTime >= 0) {
+				float velocity = timedVelocity(distance, arrivalTime, speed, acc, dec);
+				velGoal = (velocity < 0 || velocity > maxVel)? maxVel : velocity;
+				arrivalTime = (arrivalTime > dT)? arrivalTime - dT : 0;
+			}
+
+			if (speed < 0) {
+				// Moving away from the target, so turn around. The speed stops
+				// at zero, so it never changes faster than the deceleration
+				speed += stopStep;
+				if (speed > 0) speed = 0;
+			} else {
+				// Accelerate up to the velocity limit, or slow down to the
+				// lower velocity limit of a new move
+				float newSpeed = speed + acc * dT;
+				if (newSpeed > velGoal) newSpeed = (speed > velGoal)? max(speed - stopStep, velGoal) : velGoal;
+
+				// Limit the speed so that the system can still stop at the target after
+				// this update; the fastest speed is the solution of v*dT + v^2/(2*dec) = distance.
+				// The limit is skipped if no time has passed, as the speed can't change
+				if (distance <= 0) {
+					newSpeed = 0;
+				} else if (dT > 0 && newSpeed * dT + newSpeed * newSpeed * halfInvDec > distance) {
+					newSpeed = 2 * distance / (dT + sqrt(dT * dT + 4 * halfInvDec * distance));
+				}
+
+				// The system can't slow down faster than the deceleration
+				if (newSpeed < speed - stopStep) newSpeed = speed - stopStep;
+				speed = newSpeed;
+			}
 
 			// Update the current velocity
-			if (dir) curVel += acceleration * dT;
-			else curVel -= acceleration * dT;
-
-			// Limit Velocity
-			if (curVel > velGoal) curVel = velGoal;
-			else if (curVel < -velGoal) curVel = -velGoal;
-			
-			float dP = curVel * dT;
-
-			// Prevent overshooting/jittering around target
-			if (abs(dP) < abs(posError)) curPos += dP;
-			else curPos = target;
+			curVel = speed * dir;
+
+			// Settle at the target if this update reaches or passes it, and the
+			// speed can be stopped within one update. Otherwise the system is
+			// moving too fast, and overshoots before turning around
+			if (speed > 0 && speed * dT >= distance && lastSpeed <= stopStep) {
+				curVel = 0;
+				curPos = target;
+				posCarry = 0;
+				noTasks = true;
+			} else {
+				movePos(curVel * dT);
+			}
 
 			//Serial.print(millis()); Serial.print(",");
 			//Serial.print(curPos); Serial.print(",");
-			//Serial.print(curVel); Serial.print(",");
-			//if (abs(curVel) != velGoal) Serial.println(acceleration * (-1 + 2*dir));
-			//else Serial.println(0);
+			//Serial.println(curVel);
 
 		} else {
 			curVel = 0;
 			curPos = target;
+			posCarry = 0;
 			noTasks = true;
 		}
 
@@ -244,21 +376,17 @@ float Trajectory::update(float dT) {
 
 		float velError = target - curVel;
 
-		// If velocity error is above the threshold
-		if (abs(velError) > threshold) {
-
-			// Determine whether to accelerate or decelerate
-			float acceleration = acc;
-			if (target < curVel && curVel >= 0) acceleration = -dec;
-			else if (target < curVel && curVel < 0) acceleration = -acc; 
-			else if (target > curVel && curVel < 0) acceleration = dec;
-
-			// Update the current velocity
-			float dV = acceleration * dT;
-			if (abs(dV) < abs(velError)) curVel += dV;
-			else curVel = target;
-
-		} else {
+		// Determine whether to accelerate or decelerate
+		float acceleration = acc;
+		if (target < curVel && curVel > 0) acceleration = -dec;
+		else if (target < curVel && curVel <= 0) acceleration = -acc; 
+		else if (target > curVel && curVel < 0) acceleration = dec;
+
+		// Update the current velocity. The target velocity is only reached
+		// once it is within one step, so the velocity never jumps to it
+		float dV = acceleration * dT;
+		if (abs(dV) < abs(velError)) curVel += dV;
+		else {
 			curVel = target;
 			noTasks = true;
 		}
@@ -268,9 +396,14 @@ float Trajectory::update(float dT) {
 		else if (curVel < -maxVel) curVel = -maxVel;
 
 		// Update current position
-		curPos += curVel * dT;
+		movePos(curVel * dT);
 	}
 
+	// The commanded acceleration is the actual change of the velocity, so it
+	// is also correct when the velocity was limited or snapped to its goal
+	if (dT > 0) curAcc = (curVel - lastVel) / dT;
+	else curAcc = 0;
+
 	// Error check for NaN
 	//if (curPos != curPos) {
 	//	//printf(F("ERROR: Dynamics calculation error"));
@@ -298,6 +431,94 @@ float Trajectory::update() {
 
 
 
+/**
+ * Render the motion profile into a buffer
+ *
+ * The controller is updated once for each sample, until either the
+ * target has been reached or the buffer is full. The trajectory is
+ * left at the state of the last sample, so a long move can also be
+ * rendered in several smaller chunks.
+ *
+ * @param  (posBuffer) Array into which the positions are saved
+ * @param  (length) The number of samples which fit in the array(s)
+ * @param  (dT) The time (ms) between each sample
+ * @param  (velBuffer) Optional array into which the velocities are saved
+ * @return The number of samples which were written to the buffer
+ */
+uint16_t Trajectory::render(float *posBuffer, uint16_t length, float dT, float *velBuffer) {
+	uint16_t i = 0;
+	while (i < length && !noTasks) {
+		posBuffer[i] = update(dT);
+		if (velBuffer != NULL) velBuffer[i] = curVel;
+		i++;
+	}
+	return i;
+}
+
+
+/**
+ * Render the motion profile into a buffer of 16-bit integers
+ *
+ * @param  (posBuffer) Array into which the positions are saved
+ * @param  (length) The number of samples which fit in the array
+ * @param  (dT) The time (ms) between each sample
+ * @param  (scale) Each position is multiplied by this value and rounded - default = 1
+ * @return The number of samples which were written to the buffer
+ * @note   For example, a scale of 10 stores servo angles with a resolution of 0.1°
+ */
+uint16_t Trajectory::render(int16_t *posBuffer, uint16_t length, float dT, float scale) {
+	uint16_t i = 0;
+	while (i < length && !noTasks) {
+		posBuffer[i] = round(update(dT) * scale);
+		i++;
+	}
+	return i;
+}
+
+
+/**
+ * Render the motion profile as 8-bit changes between each sample
+ *
+ * This uses half the memory of the 16-bit buffer. The original
+ * positions can be recovered by adding up the changes, starting
+ * with the value returned in "startPos".
+ *
+ * @param  (deltaBuffer) Array into which the position changes are saved
+ * @param  (length) The number of samples which fit in the array
+ * @param  (dT) The time (ms) between each sample
+ * @param  (startPos) Returns the scaled and rounded position before the first sample
+ * @param  (scale) Each position is multiplied by this value and rounded - default = 1
+ * @return The number of samples which were written to the buffer
+ * @note   If the change between two samples does not fit into 8 bits, it
+ *         is limited to +/-127 and the remainder is carried over to the
+ *         following samples; if this occurs, reduce "dT" or "scale".
+ *         Extra samples are added at the end until the remainder is used
+ *         up, so the table always finishes at the target position (as
+ *         long as the buffer is long enough)
+ */
+uint16_t Trajectory::renderDelta(int8_t *deltaBuffer, uint16_t length, float dT, int16_t &startPos, float scale) {
+	int16_t lastPos = round(curPos * scale);
+	startPos = lastPos;
+
+	uint16_t i = 0;
+	while (i < length) {
+
+		// Once the target is reached, only the carried over remainder is left
+		if (!noTasks) update(dT);
+		int16_t newPos = round(curPos * scale);
+		if (noTasks && newPos == lastPos) break;
+
+		int16_t delta = newPos - lastPos;
+		if (delta > 127) delta = 127;
+		else if (delta < -127) delta = -127;
+		deltaBuffer[i] = delta;
+		lastPos += delta;
+		i++;
+	}
+	return i;
+}
+
+
 /**
  * Reset all class variables
  *
@@ -305,9 +526,12 @@ float Trajectory::update() {
  */
 void Trajectory::reset(float newPos) { 
 	curPos = newPos;
+	posCarry = 0;
 	curVel = 0;
+	curAcc = 0;
 	target = 0;
 	velGoal = maxVel;
+	arrivalTime = -1;
 	noTasks = true;
 	oldTime = millis();
 }
@@ -320,6 +544,24 @@ void Trajectory::reset(float newPos) {
  */
 void Trajectory::setPos(float newPos) {
 	curPos = newPos;
+	posCarry = 0;
+}
+
+
+/**
+ * Add a step to the current position
+ *
+ * @param  (dP) The position step
+ * @note   The part of the step which is lost to rounding is carried over
+ *         to the next update (Kahan summation). Otherwise very slow moves
+ *         far away from zero could stop moving, because each step would
+ *         be smaller than the resolution of the float position
+ */
+void Trajectory::movePos(float dP) {
+	float step = dP + posCarry;
+	float newPos = curPos + step;
+	posCarry = step - (newPos - curPos);
+	curPos = newPos;
 }
 
 
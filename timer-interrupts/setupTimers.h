@@ -42,20 +42,25 @@ ISR(TIMER2_COMPA_vect) {
 
 
 /*********************************************
- * Determine Prescale and Clockmatch Values
+ * Prescale values available on each timer
+ * (Timer2 has its own set, with different bits)
  *********************************************/
-void determinePrescaler(uint16_t frequency, bool max16bit, uint16_t &prescale, uint16_t &clockmatch) {
+const uint16_t timer01Prescalers[] = {1, 8, 64, 256, 1024};
+const uint16_t timer2Prescalers[] = {1, 8, 32, 64, 128, 256, 1024};
+
 
-	// Figure out what prescaler and match reference to use
-	int prescaleValues[] = {1, 8, 64, 256, 1024};
+/*********************************************
+ * Determine Prescale and Clockmatch Values
+ *********************************************/
+void determinePrescaler(uint16_t frequency, bool max16bit, const uint16_t *prescaleValues, uint8_t numValues, uint16_t &prescale, uint16_t &clockmatch) {
 
 	prescale = 0;
 	clockmatch = 0;
 
 	// Iterate through each prescaler to see if it would be suitable
-	for(int i = 0; i < 5; i++) {
+	for(int i = 0; i < numValues; i++) {
 		prescale = prescaleValues[i];
-		uint32_t value = (uint32_t) ((16000000 / float(prescale * frequency)) - 1);
+		uint32_t value = (uint32_t) ((16000000 / (float(prescale) * frequency)) - 1);
 		
 		if (value > 0 && ((max16bit && value < 65536) || (!max16bit && value < 256))) {
 			clockmatch = value;
@@ -93,13 +98,13 @@ void setupTimer0(uint16_t frequency) {
 	// Determine the prescale and clockmatch values for the required frequency
 	uint16_t prescale;
 	uint16_t clockmatch;
-	determinePrescaler(frequency, false, prescale, clockmatch);
+	determinePrescaler(frequency, false, timer01Prescalers, 5, prescale, clockmatch);
 
 	// Sets the counter compare value
 	OCR0A = clockmatch;
 
 	// Enable the CTC mode
-	TCCR0B |= (1 << WGM01);
+	TCCR0A |= (1 << WGM01);
 
 	// Sets the control scale bits for the timer
 	if (prescale == 1) TCCR0B |= (1 << CS00);
@@ -134,7 +139,7 @@ void setupTimer1(uint16_t frequency) {
 	// Determine the prescale and clockmatch values for the required frequency
 	uint16_t prescale;
 	uint16_t clockmatch;
-	determinePrescaler(frequency, true, prescale, clockmatch);
+	determinePrescaler(frequency, true, timer01Prescalers, 5, prescale, clockmatch);
 
 	// Sets the counter compare value
 	OCR1A = clockmatch;
@@ -176,20 +181,22 @@ void setupTimer2(uint16_t frequency) {
 	// Determine the prescale and clockmatch values for the required frequency
 	uint16_t prescale;
 	uint16_t clockmatch;
-	determinePrescaler(frequency, false, prescale, clockmatch);
+	determinePrescaler(frequency, false, timer2Prescalers, 7, prescale, clockmatch);
 
 	// Sets the counter compare value
 	OCR2A = clockmatch;
 
 	// Enable the CTC mode
-	TCCR2B |= (1 << WGM21);
+	TCCR2A |= (1 << WGM21);
 
 	// Sets the control scale bits for the timer
 	if (prescale == 1) TCCR2B |= (1 << CS20);
 	else if (prescale == 8) TCCR2B |= (1 << CS21);
-	else if (prescale == 64) TCCR2B |= (1 << CS20) | (1 << CS21);
-	else if (prescale == 256) TCCR2B |= (1 << CS22);
-	else if (prescale == 1024) TCCR2B |= (1 << CS22) | (1 << CS20);
+	else if (prescale == 32) TCCR2B |= (1 << CS21) | (1 << CS20);
+	else if (prescale == 64) TCCR2B |= (1 << CS22);
+	else if (prescale == 128) TCCR2B |= (1 << CS22) | (1 << CS20);
+	else if (prescale == 256) TCCR2B |= (1 << CS22) | (1 << CS21);
+	else if (prescale == 1024) TCCR2B |= (1 << CS22) | (1 << CS21) | (1 << CS20);
 
 	// Enable the timer compare interrupt
 	TIMSK2 |= (1 << OCIE2A);